@@ -0,0 +1,23 @@
+#ifndef BAND_H
+#define BAND_H
+
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* solve a 9x9 grid on a fixed-size state: for each color, the cells where it
+ * may still go in each of the 3 bands of 3 rows, 27 bits per band. the state
+ * lives on the stack, the propagation places the naked and hidden singles
+ * with a few masks per band. the solution is written back in the grid.
+ * returns 0 if the grid is solved and 2 if it has no solution, the grids of
+ * the other sizes are handed to grid_solve(). */
+size_t band_solve(grid_t* grid);
+
+/* solve a 9x9 grid given as its 81 cells row by row, each one a color of
+ * color_table or EMPTY_CELL, without building a grid_t. the cells are
+ * overwritten by the solution. returns 0 if the grid is solved and 2 if it
+ * has no solution or a cell is neither a color nor empty. */
+size_t band_solve_cells(char cells[81]);
+
+#endif /* BAND_H */
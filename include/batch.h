@@ -0,0 +1,20 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* number of 9x9 grids propagated together by batch_solve() */
+#define BATCH_LANES 16
+
+/* solve a batch of grids, statuses[i] receiving the status of grids[i] (0 if
+ * solved, 1 if not, 2 if inconsistent). the 9x9 grids are packed
+ * BATCH_LANES at a time, one 16-bit candidate set per cell and per grid, and
+ * the cross-hatching and the lone numbers run on all of them in lockstep.
+ * the grids which are not solved by this propagation alone are finished by
+ * band_solve(), those of the other sizes by grid_solve(). */
+void batch_solve(grid_t* grids[], size_t statuses[], const size_t nb_grids);
+
+#endif /* BATCH_H */
@@ -0,0 +1,16 @@
+#ifndef BITPLANE_H
+#define BITPLANE_H
+
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* solve the grid on a color-major copy of its candidates left by the
+ * heuristics: one bitboard per color of the cells where it may still go. the
+ * eliminations, the naked and hidden singles, the pointing and the claiming
+ * are word-wide operations on these bitboards. the solution is written back
+ * in the grid. returns 0 if the grid is solved and 2 if it has no solution. */
+size_t bitplane_solve(grid_t* grid);
+
+#endif /* BITPLANE_H */
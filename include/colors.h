@@ -6,67 +6,231 @@
 #include <unistd.h>
 
 #define MAX_COLORS 64
+
+/* heuristics run by subgrid_heuristics(), to be combined with '|'. the
+ * intersections and the fish cross the units, they are run by
+ * grid_heuristics(). */
+typedef enum {
+  HEURISTIC_CROSS_HATCHING = 1 << 0,
+  HEURISTIC_LONE_NUMBER = 1 << 1,
+  HEURISTIC_NAKED_SUBSET = 1 << 2,
+  HEURISTIC_HIDDEN_SUBSET = 1 << 3,
+  HEURISTIC_INTERSECTION = 1 << 4,
+  HEURISTIC_FISH = 1 << 5,
+} heuristic_t;
+
+#define HEURISTICS_DEFAULT                                                     \
+  (HEURISTIC_CROSS_HATCHING | HEURISTIC_LONE_NUMBER |                          \
+   HEURISTIC_NAKED_SUBSET | HEURISTIC_HIDDEN_SUBSET | HEURISTIC_INTERSECTION | \
+   HEURISTIC_FISH)
+#define SUBSET_MAX_DEFAULT 4
 #define FULL 9223372036854775807
 typedef uint64_t colors_t;
 
+/* the primitives below are inlined, the bit counting and scanning ones use
+ * the compiler builtins when available, portable code otherwise */
+#if defined(__GNUC__) || defined(__clang__)
+#define COLORS_HAVE_BUILTINS 1
+#endif
+
 /* set all the bits at 1, set all the possible colors for a given size */
-colors_t colors_full (const size_t size);
+static inline colors_t colors_full(const size_t size) {
+  if (size < MAX_COLORS) {
+    return (((colors_t)1 << size) - 1);
+  }
+  return ~(colors_t)0;
+}
 
 /* returns the empty colors_t 0. */
-colors_t colors_empty (void);
+static inline colors_t colors_empty(void) { return (colors_t)0; }
 
 /* shift 1 by the color_id and returns the newly created color */
-colors_t colors_set (const size_t color_id);
+static inline colors_t colors_set(const size_t color_id) {
+  if (color_id < MAX_COLORS) {
+    return ((colors_t)1 << color_id);
+  }
+  return colors_empty();
+}
 
 /* add a new color to the existing colors_t */
-colors_t colors_add(const colors_t colors, const size_t color_id);
+static inline colors_t colors_add(const colors_t colors,
+                                  const size_t color_id) {
+  return colors | colors_set(color_id);
+}
 
 /* discard a color from the existing colors_t */
-colors_t colors_discard(const colors_t colors, const size_t color_id);
+static inline colors_t colors_discard(const colors_t colors,
+                                      const size_t color_id) {
+  return colors & ~colors_set(color_id);
+}
 
 /* returns true if the color index is set to '1', false otherwise. */
-bool colors_is_in(const colors_t colors, const size_t color_id);
+static inline bool colors_is_in(const colors_t colors, const size_t color_id) {
+  return (colors & colors_set(color_id)) != 0;
+}
 
 /* Bitwise operation to negate the colors_t and returns it. */
-colors_t colors_negate(const colors_t colors);
+static inline colors_t colors_negate(const colors_t colors) {
+  return ~colors;
+}
 
 /* computes the intersection between 2 colors_t and returns it. */
-colors_t colors_and(const colors_t colors1, const colors_t colors2);
+static inline colors_t colors_and(const colors_t colors1,
+                                  const colors_t colors2) {
+  return (colors1 & colors2);
+}
 
 /* returns the union of two colors_t */
-colors_t colors_or(const colors_t colors1, const colors_t colors2);
+static inline colors_t colors_or(const colors_t colors1,
+                                 const colors_t colors2) {
+  return (colors1 | colors2);
+}
 
 /* computes the xor of two colors_t */
-colors_t colors_xor(const colors_t colors1, const colors_t colors2);
+static inline colors_t colors_xor(const colors_t colors1,
+                                  const colors_t colors2) {
+  return (colors1 ^ colors2);
+}
 
 /* returns the bitwise subtract of two colors_t : colors1/colors2 */
-colors_t colors_subtract(const colors_t colors1, const colors_t colors2);
+static inline colors_t colors_subtract(const colors_t colors1,
+                                       const colors_t colors2) {
+  return colors1 & ~colors2;
+}
+
+/* returns true if the set has no color */
+static inline bool colors_is_empty(const colors_t colors) {
+  return colors == 0;
+}
 
 /* returns true if two colors are equal, false otherwise. */
-bool colors_is_equal(const colors_t colors1, const colors_t colors2);
+static inline bool colors_is_equal(const colors_t colors1,
+                                   const colors_t colors2) {
+  return colors1 == colors2;
+}
 
 /* returns true if colors1 is include in color2, false otherwise. */
-bool colors_is_subset(const colors_t colors1, const colors_t colors2);
+static inline bool colors_is_subset(const colors_t colors1,
+                                    const colors_t colors2) {
+  if (colors1 == 0 || colors2 == 0) {
+    return false;
+  }
+  return (colors1 & colors2) == colors1;
+}
 
 /* checks if there is only one color in the colors */
-bool colors_is_singleton(const colors_t colors);
+static inline bool colors_is_singleton(const colors_t colors) {
+  return colors != 0 && (colors & (colors - 1)) == 0;
+}
 
 /* returns the number of colors in a colors_t set. */
-size_t colors_count(const colors_t colors);
+static inline size_t colors_count(const colors_t colors) {
+#ifdef COLORS_HAVE_BUILTINS
+  return (size_t)__builtin_popcountll(colors);
+#else
+  uint64_t y = colors;
+  y -= ((y >> 1) & 0x5555555555555555ull);
+  y = (y & 0x3333333333333333ull) + (y >> 2 & 0x3333333333333333ull);
+  return ((y + (y >> 4)) & 0xf0f0f0f0f0f0f0full) * 0x101010101010101ull >> 56;
+#endif
+}
 
 /* returns the rightmost color of a colors_t set */
-colors_t colors_rightmost(const colors_t colors);
+static inline colors_t colors_rightmost(const colors_t colors) {
+  return (colors & (-colors));
+}
 
 /* returns the leftmost color of a colors_t set  */
-colors_t colors_leftmost(const colors_t colors);
+static inline colors_t colors_leftmost(const colors_t colors) {
+  if (colors == 0) {
+    return colors_empty();
+  }
+#ifdef COLORS_HAVE_BUILTINS
+  return (colors_t)1 << (63 - __builtin_clzll(colors));
+#else
+  colors_t y = colors;
+  y |= y >> 1;
+  y |= y >> 2;
+  y |= y >> 4;
+  y |= y >> 8;
+  y |= y >> 16;
+  y |= y >> 32;
+  return y ^ (y >> 1);
+#endif
+}
+
+/* returns the index of the rightmost color of a non empty colors_t set */
+static inline size_t colors_rightmost_id(const colors_t colors) {
+#ifdef COLORS_HAVE_BUILTINS
+  return (size_t)__builtin_ctzll(colors);
+#else
+  return colors_count(colors_rightmost(colors) - 1);
+#endif
+}
+
+/* returns the index of the rightmost color of a non empty colors_t set and
+ * removes it from the set */
+static inline size_t colors_next(colors_t *colors) {
+  size_t color_id = colors_rightmost_id(*colors);
+  *colors &= *colors - 1;
+  return color_id;
+}
+
+/* visits the indices of the colors of a set, from the rightmost one, as in
+ * 'colors_foreach (color_id, colors) { ... }'. the set is only evaluated
+ * once and 'break' leaves the loop. */
+#define colors_foreach(color_id, colors)                                       \
+  for (colors_t colors_rest_ = (colors); colors_rest_ != 0; colors_rest_ = 0)  \
+    for (size_t color_id; colors_rest_ != 0 &&                                 \
+                          ((color_id = colors_next(&colors_rest_)), true);)
 
 /* generates a random colors_t set */
 colors_t colors_random(const colors_t colors);
 
-/* check if the subgrid has no same singletons, each color, and is not empty. */
+/* called on each locked set found by colors_locked_sets(): members holds the
+ * indices of the chosen masks, colors the union of these masks */
+typedef bool (*colors_locked_set_found_t)(const colors_t members,
+                                          const colors_t colors, void *data);
+
+/* calls found() on each set of k masks, 2 <= k <= max, whose union has
+ * exactly k colors, masks with less than 2 colors are never chosen. returns
+ * true if one of the calls did. */
+bool colors_locked_sets(const colors_t masks[], const size_t nb_masks,
+                        const size_t max, colors_locked_set_found_t found,
+                        void *data);
+
+/* check if the subgrid has no same singletons, each color, and is not empty.
+ * the cells are reduced in a single pass. */
 bool subgrid_consistency(colors_t subgrid[], const size_t size);
 
+/* apply the selected heuristics to the cells of a unit, returns true if a cell
+ * has changed. */
 bool subgrid_heuristics(colors_t* subgrid[], const size_t size);
 
+/* apply the given heuristics (HEURISTIC_* flags) rather than the selected
+ * ones, returns true if a cell has changed. */
+bool subgrid_apply(colors_t *subgrid[], const size_t size,
+                   const unsigned heuristics);
+
+/* subgrid_heuristics() and subgrid_apply() specialized for the units of 36,
+ * 49 and 64 cells, size must be the one of the function */
+bool subgrid36_heuristics(colors_t *subgrid[], const size_t size);
+bool subgrid49_heuristics(colors_t *subgrid[], const size_t size);
+bool subgrid64_heuristics(colors_t *subgrid[], const size_t size);
+bool subgrid36_apply(colors_t *subgrid[], const size_t size,
+                     const unsigned heuristics);
+bool subgrid49_apply(colors_t *subgrid[], const size_t size,
+                     const unsigned heuristics);
+bool subgrid64_apply(colors_t *subgrid[], const size_t size,
+                     const unsigned heuristics);
+
+/* select the heuristics run by subgrid_heuristics() (HEURISTIC_* flags) and
+ * the maximum number of cells of the subsets they look for */
+void subgrid_heuristics_select(const unsigned heuristics,
+                               const size_t max_subset);
+
+/* returns the heuristics currently selected (HEURISTIC_* flags) */
+unsigned subgrid_heuristics_selected(void);
+
 #endif /* colors_h */
 
@@ -0,0 +1,59 @@
+#ifndef COLORS_NARROW_H
+#define COLORS_NARROW_H
+
+#include "colors.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Candidate sets narrower than colors_t, for the small grids: 16 bits up to
+ * 16x16 and 32 bits up to 25x25, so that more cells fit in a cache line.
+ * Each width has the same operations as colors_t, prefixed by its number of
+ * bits: colors16_and(), colors32_count(), ... They are computed on colors_t
+ * and truncated back. */
+
+/* visits the indices of the colors of a narrow set, see colors_foreach() */
+#define COLORS_NARROW_FOREACH(prefix, color_id, colors)                        \
+  for (prefix##_t colors_rest_ = (colors); colors_rest_ != 0;                  \
+       colors_rest_ = 0)                                                       \
+    for (size_t color_id; colors_rest_ != 0 &&                                 \
+                          ((color_id = prefix##_next(&colors_rest_)), true);)
+
+#define COLORS_NARROW_TYPE uint16_t
+#define COLORS_NARROW_BITS 16
+#include "colors_narrow_template.h"
+#undef COLORS_NARROW_TYPE
+#undef COLORS_NARROW_BITS
+#define colors16_foreach(color_id, colors)                                     \
+  COLORS_NARROW_FOREACH(colors16, color_id, colors)
+
+#define COLORS_NARROW_TYPE uint32_t
+#define COLORS_NARROW_BITS 32
+#include "colors_narrow_template.h"
+#undef COLORS_NARROW_TYPE
+#undef COLORS_NARROW_BITS
+#define colors32_foreach(color_id, colors)                                     \
+  COLORS_NARROW_FOREACH(colors32, color_id, colors)
+
+/* subgrid_heuristics() and subgrid_apply() on 16-bit sets */
+bool colors16_subgrid_heuristics(colors16_t *subgrid[], const size_t size);
+bool colors16_subgrid_apply(colors16_t *subgrid[], const size_t size,
+                            const unsigned heuristics);
+
+/* and specialized for the units of 4, 9, 16 and 25 cells, size must be the
+ * one of the function. the 32-bit sets only have the 25-cell version. */
+bool colors16_subgrid4_heuristics(colors16_t *subgrid[], const size_t size);
+bool colors16_subgrid9_heuristics(colors16_t *subgrid[], const size_t size);
+bool colors16_subgrid16_heuristics(colors16_t *subgrid[], const size_t size);
+bool colors32_subgrid25_heuristics(colors32_t *subgrid[], const size_t size);
+bool colors16_subgrid4_apply(colors16_t *subgrid[], const size_t size,
+                             const unsigned heuristics);
+bool colors16_subgrid9_apply(colors16_t *subgrid[], const size_t size,
+                             const unsigned heuristics);
+bool colors16_subgrid16_apply(colors16_t *subgrid[], const size_t size,
+                              const unsigned heuristics);
+bool colors32_subgrid25_apply(colors32_t *subgrid[], const size_t size,
+                              const unsigned heuristics);
+
+#endif /* COLORS_NARROW_H */
@@ -0,0 +1,105 @@
+/* Operations of a narrow colors set of type COLORS_NARROW_TYPE, named after
+ * its COLORS_NARROW_BITS bits. Included once per width by colors_narrow.h,
+ * which defines these two macros, so there is no include guard. */
+
+#define CN_PASTE(bits, op) colors##bits##_##op
+#define CN_NAME(bits, op) CN_PASTE(bits, op)
+#define CN(op) CN_NAME(COLORS_NARROW_BITS, op)
+#define CN_T CN(t)
+
+typedef COLORS_NARROW_TYPE CN_T;
+
+static inline CN_T CN(empty)(void) { return 0; }
+
+static inline CN_T CN(full)(const size_t size) {
+  if (size < COLORS_NARROW_BITS) {
+    return (CN_T)colors_full(size);
+  }
+  return (CN_T)~(CN_T)0;
+}
+
+static inline CN_T CN(set)(const size_t color_id) {
+  if (color_id < COLORS_NARROW_BITS) {
+    return (CN_T)colors_set(color_id);
+  }
+  return 0;
+}
+
+static inline CN_T CN(add)(const CN_T colors, const size_t color_id) {
+  return colors | CN(set)(color_id);
+}
+
+static inline CN_T CN(discard)(const CN_T colors, const size_t color_id) {
+  return colors & (CN_T)~CN(set)(color_id);
+}
+
+static inline bool CN(is_in)(const CN_T colors, const size_t color_id) {
+  return (colors & CN(set)(color_id)) != 0;
+}
+
+static inline CN_T CN(negate)(const CN_T colors) { return (CN_T)~colors; }
+
+static inline CN_T CN(and)(const CN_T colors1, const CN_T colors2) {
+  return colors1 & colors2;
+}
+
+static inline CN_T CN(or)(const CN_T colors1, const CN_T colors2) {
+  return colors1 | colors2;
+}
+
+static inline CN_T CN(xor)(const CN_T colors1, const CN_T colors2) {
+  return colors1 ^ colors2;
+}
+
+static inline CN_T CN(subtract)(const CN_T colors1, const CN_T colors2) {
+  return colors1 & (CN_T)~colors2;
+}
+
+static inline bool CN(is_empty)(const CN_T colors) { return colors == 0; }
+
+static inline bool CN(is_equal)(const CN_T colors1, const CN_T colors2) {
+  return colors1 == colors2;
+}
+
+static inline bool CN(is_subset)(const CN_T colors1, const CN_T colors2) {
+  return colors_is_subset(colors1, colors2);
+}
+
+static inline bool CN(is_singleton)(const CN_T colors) {
+  return colors_is_singleton(colors);
+}
+
+static inline size_t CN(count)(const CN_T colors) {
+  return colors_count(colors);
+}
+
+static inline CN_T CN(rightmost)(const CN_T colors) {
+  return (CN_T)colors_rightmost(colors);
+}
+
+static inline CN_T CN(leftmost)(const CN_T colors) {
+  return (CN_T)colors_leftmost(colors);
+}
+
+static inline size_t CN(rightmost_id)(const CN_T colors) {
+  return colors_rightmost_id(colors);
+}
+
+static inline size_t CN(next)(CN_T *colors) {
+  size_t color_id = colors_rightmost_id(*colors);
+  *colors &= *colors - 1;
+  return color_id;
+}
+
+/* see colors_locked_sets() */
+typedef bool (*CN(locked_set_found_t))(const CN_T members, const CN_T colors,
+                                       void *data);
+
+bool CN(locked_sets)(const CN_T masks[], const size_t nb_masks,
+                     const size_t max, CN(locked_set_found_t) found,
+                     void *data);
+
+#undef CN_T
+#undef CN
+#undef CN_NAME
+#undef CN_PASTE
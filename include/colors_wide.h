@@ -0,0 +1,41 @@
+#ifndef COLORS_WIDE_H
+#define COLORS_WIDE_H
+
+#include "colors.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Candidate sets wider than colors_t, for the grids with more than
+ * MAX_COLORS colors. A set is an array of 64 bits words, the bitwise
+ * operations are straight loops over the words which the compiler turns into
+ * vector instructions. Each width has the same operations as colors_t,
+ * prefixed by its number of bits: colors128_and(), colors256_count(), ... */
+
+#define MAX_WIDE_COLORS 256
+
+/* visits the indices of the colors of a wide set, see colors_foreach() */
+#define COLORS_WIDE_FOREACH(prefix, color_id, colors)                          \
+  for (prefix##_t colors_rest_ = (colors); !prefix##_is_empty(colors_rest_);   \
+       colors_rest_ = prefix##_empty())                                        \
+    for (size_t color_id; !prefix##_is_empty(colors_rest_) &&                  \
+                          ((color_id = prefix##_next(&colors_rest_)), true);)
+
+#define COLORS_WIDE_WORDS 2
+#define COLORS_WIDE_BITS 128
+#include "colors_wide_template.h"
+#undef COLORS_WIDE_WORDS
+#undef COLORS_WIDE_BITS
+#define colors128_foreach(color_id, colors)                                    \
+  COLORS_WIDE_FOREACH(colors128, color_id, colors)
+
+#define COLORS_WIDE_WORDS 4
+#define COLORS_WIDE_BITS 256
+#include "colors_wide_template.h"
+#undef COLORS_WIDE_WORDS
+#undef COLORS_WIDE_BITS
+#define colors256_foreach(color_id, colors)                                    \
+  COLORS_WIDE_FOREACH(colors256, color_id, colors)
+
+#endif /* COLORS_WIDE_H */
@@ -0,0 +1,194 @@
+/* Operations of a wide colors set of COLORS_WIDE_WORDS words, named after its
+ * COLORS_WIDE_BITS bits. Included once per width by colors_wide.h, which
+ * defines these two macros, so there is no include guard. */
+
+#define CW_PASTE(bits, op) colors##bits##_##op
+#define CW_NAME(bits, op) CW_PASTE(bits, op)
+#define CW(op) CW_NAME(COLORS_WIDE_BITS, op)
+#define CW_T CW(t)
+
+typedef struct {
+  uint64_t words[COLORS_WIDE_WORDS];
+} CW_T;
+
+/* applies a bitwise expression of the words w1 and w2 to all the words */
+#define CW_MAP(colors1, colors2, expr)                                         \
+  CW_T result;                                                                 \
+  for (size_t i = 0; i < COLORS_WIDE_WORDS; i++) {                             \
+    uint64_t w1 = (colors1).words[i];                                          \
+    uint64_t w2 = (colors2).words[i];                                          \
+    result.words[i] = (expr);                                                  \
+  }                                                                            \
+  return result
+
+/* returns the empty set */
+static inline CW_T CW(empty)(void) { return (CW_T){{0}}; }
+
+/* returns all the possible colors for a given size */
+static inline CW_T CW(full)(const size_t size) {
+  CW_T colors = CW(empty)();
+  for (size_t i = 0; i < COLORS_WIDE_WORDS; i++) {
+    if (size >= 64 * (i + 1)) {
+      colors.words[i] = ~(uint64_t)0;
+    } else if (size > 64 * i) {
+      colors.words[i] = ((uint64_t)1 << (size - 64 * i)) - 1;
+    }
+  }
+  return colors;
+}
+
+/* returns the set holding only the given color */
+static inline CW_T CW(set)(const size_t color_id) {
+  CW_T colors = CW(empty)();
+  if (color_id < COLORS_WIDE_BITS) {
+    colors.words[color_id / 64] = (uint64_t)1 << (color_id % 64);
+  }
+  return colors;
+}
+
+/* add a color to a set */
+static inline CW_T CW(add)(const CW_T colors, const size_t color_id) {
+  CW_T result = colors;
+  if (color_id < COLORS_WIDE_BITS) {
+    result.words[color_id / 64] |= (uint64_t)1 << (color_id % 64);
+  }
+  return result;
+}
+
+/* discard a color from a set */
+static inline CW_T CW(discard)(const CW_T colors, const size_t color_id) {
+  CW_T result = colors;
+  if (color_id < COLORS_WIDE_BITS) {
+    result.words[color_id / 64] &= ~((uint64_t)1 << (color_id % 64));
+  }
+  return result;
+}
+
+/* returns true if the color is in the set */
+static inline bool CW(is_in)(const CW_T colors, const size_t color_id) {
+  if (color_id >= COLORS_WIDE_BITS) {
+    return false;
+  }
+  return (colors.words[color_id / 64] >> (color_id % 64)) & 1;
+}
+
+static inline CW_T CW(and)(const CW_T colors1, const CW_T colors2) {
+  CW_MAP(colors1, colors2, w1 & w2);
+}
+
+static inline CW_T CW(or)(const CW_T colors1, const CW_T colors2) {
+  CW_MAP(colors1, colors2, w1 | w2);
+}
+
+static inline CW_T CW(xor)(const CW_T colors1, const CW_T colors2) {
+  CW_MAP(colors1, colors2, w1 ^ w2);
+}
+
+/* returns colors1/colors2 */
+static inline CW_T CW(subtract)(const CW_T colors1, const CW_T colors2) {
+  CW_MAP(colors1, colors2, w1 & ~w2);
+}
+
+static inline CW_T CW(negate)(const CW_T colors) {
+  return CW(subtract)(CW(full)(COLORS_WIDE_BITS), colors);
+}
+
+/* returns true if the set has no color */
+static inline bool CW(is_empty)(const CW_T colors) {
+  uint64_t words = 0;
+  for (size_t i = 0; i < COLORS_WIDE_WORDS; i++) {
+    words |= colors.words[i];
+  }
+  return words == 0;
+}
+
+static inline bool CW(is_equal)(const CW_T colors1, const CW_T colors2) {
+  return CW(is_empty)(CW(xor)(colors1, colors2));
+}
+
+/* returns true if colors1 is included in colors2, both being non empty */
+static inline bool CW(is_subset)(const CW_T colors1, const CW_T colors2) {
+  if (CW(is_empty)(colors1) || CW(is_empty)(colors2)) {
+    return false;
+  }
+  return CW(is_empty)(CW(subtract)(colors1, colors2));
+}
+
+/* returns the number of colors of a set */
+static inline size_t CW(count)(const CW_T colors) {
+  size_t count = 0;
+  for (size_t i = 0; i < COLORS_WIDE_WORDS; i++) {
+    count += colors_count(colors.words[i]);
+  }
+  return count;
+}
+
+static inline bool CW(is_singleton)(const CW_T colors) {
+  return CW(count)(colors) == 1;
+}
+
+/* returns the rightmost color of a set */
+static inline CW_T CW(rightmost)(const CW_T colors) {
+  CW_T rightmost = CW(empty)();
+  for (size_t i = 0; i < COLORS_WIDE_WORDS; i++) {
+    if (colors.words[i] != 0) {
+      rightmost.words[i] = colors_rightmost(colors.words[i]);
+      break;
+    }
+  }
+  return rightmost;
+}
+
+/* returns the leftmost color of a set */
+static inline CW_T CW(leftmost)(const CW_T colors) {
+  CW_T leftmost = CW(empty)();
+  for (size_t i = COLORS_WIDE_WORDS; i-- > 0;) {
+    if (colors.words[i] != 0) {
+      leftmost.words[i] = colors_leftmost(colors.words[i]);
+      break;
+    }
+  }
+  return leftmost;
+}
+
+/* returns the index of the rightmost color of a non empty set */
+static inline size_t CW(rightmost_id)(const CW_T colors) {
+  size_t i = 0;
+  while (i < COLORS_WIDE_WORDS - 1 && colors.words[i] == 0) {
+    i++;
+  }
+  return 64 * i + colors_rightmost_id(colors.words[i]);
+}
+
+/* returns the index of the rightmost color of a non empty set and removes it
+ * from the set */
+static inline size_t CW(next)(CW_T *colors) {
+  size_t i = 0;
+  while (i < COLORS_WIDE_WORDS - 1 && colors->words[i] == 0) {
+    i++;
+  }
+  return 64 * i + colors_next(&(colors->words[i]));
+}
+
+/* see colors_locked_sets() */
+typedef bool (*CW(locked_set_found_t))(const CW_T members, const CW_T colors,
+                                       void *data);
+
+bool CW(locked_sets)(const CW_T masks[], const size_t nb_masks,
+                     const size_t max, CW(locked_set_found_t) found,
+                     void *data);
+
+/* see subgrid_heuristics() */
+bool CW_NAME(COLORS_WIDE_BITS, subgrid_heuristics)(CW_T *subgrid[],
+                                                   const size_t size);
+
+/* see subgrid_apply() */
+bool CW_NAME(COLORS_WIDE_BITS, subgrid_apply)(CW_T *subgrid[],
+                                              const size_t size,
+                                              const unsigned heuristics);
+
+#undef CW_MAP
+#undef CW_T
+#undef CW
+#undef CW_NAME
+#undef CW_PASTE
@@ -0,0 +1,20 @@
+#ifndef DLX_H
+#define DLX_H
+
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* solve the grid as an exact cover problem with Dancing Links (Knuth's
+ * Algorithm X) restricted to the candidates of the cells left by the
+ * heuristics. a search taking more than a few hundred nodes per cell (some
+ * sparse grids from 25x25 on) is finished by grid_solve(). returns 0 if the
+ * grid is solved and 2 if it has no solution. */
+size_t dlx_solve(grid_t* grid);
+
+/* count the solutions of the grid, stopping as soon as limit solutions are
+ * found (no limit if 0). the grid is left untouched. */
+size_t dlx_count_solutions(const grid_t* grid, const size_t limit);
+
+#endif /* DLX_H */
@@ -1,7 +1,7 @@
 #ifndef GRID_H
 #define GRID_H
 
-#define MAX_GRID_SIZE 64
+#define MAX_GRID_SIZE 144
 #define EMPTY_CELL '_'
 
 #include "colors.h"
@@ -10,8 +10,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+/* the colors of the grids up to 64x64, then the remaining printable ASCII
+ * chars but '#' and '_', then Latin-1 letters (one byte each) for the grids
+ * up to 144x144 */
 static const char color_table[] =
-"123456789" "ABCDEFGHIJKLMNOPQRSTUVWXYZ" "@" "abcdefghijklmnopqrstuvwxyz" "&*";
+"123456789" "ABCDEFGHIJKLMNOPQRSTUVWXYZ" "@" "abcdefghijklmnopqrstuvwxyz" "&*"
+"0!\"$%'()+,-./:;<=>?[\\]^`{|}~"
+"\xC0\xC1\xC2\xC3\xC4\xC5\xC6\xC7\xC8\xC9\xCA\xCB\xCC\xCD\xCE\xCF"
+"\xD0\xD1\xD2\xD3\xD4\xD5\xD6\xD8\xD9\xDA\xDB\xDC\xDD\xDE\xDF"
+"\xE0\xE1\xE2\xE3\xE4\xE5\xE6\xE7\xE8\xE9\xEA\xEB\xEC\xED\xEE\xEF"
+"\xF0\xF1\xF2\xF3\xF4";
 
 /* Sudoku grid (froward declaration to hide the implementation) */
 typedef struct _grid_t grid_t;
@@ -32,6 +40,14 @@ void grid_print(grid_t* grid, FILE* fd);
 /* copy the given grid in a new memory area and returns it, NULL otherwise. */
 grid_t* grid_copy(const grid_t* grid);
 
+/* start recording the changes made to the grid cells, returns the checkpoint
+ * to give to grid_rollback() */
+size_t grid_checkpoint(grid_t* grid);
+
+/* restore the cells changed since the given checkpoint, the checkpoints taken
+ * after it can't be used anymore */
+void grid_rollback(grid_t* grid, const size_t checkpoint);
+
 /* get the content of a given cell as a string and returns it. */
 char* grid_get_cell(const grid_t* grid, const size_t row, const size_t column);
 
@@ -42,6 +58,21 @@ size_t grid_get_size(const grid_t* grid);
 void grid_set_cell(grid_t* grid, const size_t size, const size_t column,
 	const char color);
 
+/* get the candidate colors of a given cell, the empty set if out of bounds.
+ * only the first MAX_COLORS colors of the larger grids are reported. */
+colors_t grid_get_colors(const grid_t* grid, const size_t row,
+	const size_t column);
+
+/* set the candidate colors of a given cell, colors out of the grid size are
+ * dropped */
+void grid_set_colors(grid_t* grid, const size_t row, const size_t column,
+	const colors_t colors);
+
+/* check if a color (index in color_table) is a candidate of a given cell,
+ * for every grid size */
+bool grid_has_color(const grid_t* grid, const size_t row, const size_t column,
+	const size_t color_id);
+
 /* check if the grid has only singletons and is not empty */
 bool grid_is_solved(grid_t* grid);
 
@@ -50,4 +81,24 @@ bool grid_is_consistent(grid_t* grid);
 
 size_t grid_heuristics(grid_t* grid);
 
+/* solve the grid with the heuristics and a backtracking search branching on
+ * the cell with the fewest candidates. returns 0 if the grid is solved and 2
+ * if it has no solution. */
+size_t grid_solve(grid_t* grid);
+
+/* hooks of a search run by grid_search(), data is given back to both */
+typedef struct {
+  /* checked at each node, the search gives up once it returns true */
+  bool (*cancelled)(void* data);
+  /* offered each branch of a node but the last one, the grid being in the
+   * state of the branch. returns true if it takes the branch over (copying
+   * the grid), which is then skipped by the search. */
+  bool (*offer)(const grid_t* grid, void* data);
+  void* data;
+} grid_search_t;
+
+/* grid_solve() with the given hooks, 2 is also returned when the search gave
+ * up or when the solution was in a branch taken over */
+size_t grid_search(grid_t* grid, const grid_search_t* search);
+
 #endif /* GRID_H */
@@ -0,0 +1,17 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* solve a grid with the backtracking search of grid_solve() spread over a
+ * pool of nb_threads workers. a search gives a copy of its pending branches
+ * to the pool as long as a worker waits for one, the other workers steal
+ * them, and all the searches stop as soon as one of them finds a solution,
+ * which is written back in the grid. returns 0 if the grid is solved and 2
+ * if it has no solution, a single thread runs grid_solve(). */
+size_t parallel_solve(grid_t* grid, const size_t nb_threads);
+
+#endif /* PARALLEL_H */
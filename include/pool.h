@@ -0,0 +1,32 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Thread pool (forward declaration to hide the implementation) */
+typedef struct _pool_t pool_t;
+
+/* a task of the pool, run with the argument given to pool_submit() */
+typedef void (*pool_run_t)(void* arg);
+
+/* start a pool of nb_threads workers (at least one). each worker has its own
+ * deque of tasks: it runs the last task it submitted first, and a worker
+ * without tasks steals the oldest task of another one. */
+pool_t* pool_alloc(const size_t nb_threads);
+
+/* wait for the tasks of the pool, then stop its workers and free it */
+void pool_free(pool_t* pool);
+
+/* add a task to the pool, to the deque of the calling worker if it is one of
+ * the pool, otherwise to the deques in turn */
+void pool_submit(pool_t* pool, pool_run_t run, void* arg);
+
+/* wait until every submitted task has been run */
+void pool_wait(pool_t* pool);
+
+/* true if a worker waits for a task which isn't there yet, a running task may
+ * then split its work */
+bool pool_is_hungry(pool_t* pool);
+
+#endif /* POOL_H */
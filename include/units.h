@@ -0,0 +1,46 @@
+#ifndef UNITS_H
+#define UNITS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* index of a cell in a grid: row * size + column */
+typedef uint16_t cell_id_t;
+
+/* Rows, columns and blocks of a grid size, computed once per size.
+ * Units are numbered rows first, then columns, then blocks. */
+typedef struct {
+  size_t size;
+  size_t block_size;
+  size_t nb_units;
+  /* nb_units * size cell indices, the cells of the unit u start at u * size */
+  cell_id_t *cells;
+  /* 3 unit indices per cell: its row, its column and its block */
+  cell_id_t *cell_units;
+  /* 3 positions per cell: its index among the cells of each of its units */
+  cell_id_t *cell_positions;
+} units_t;
+
+/* returns the tables of a grid size, NULL if the size isn't a valid one */
+const units_t *units_get(const size_t size);
+
+/* returns the cells of a given unit */
+static inline const cell_id_t *units_cells(const units_t *units,
+                                           const size_t unit_id) {
+  return units->cells + unit_id * units->size;
+}
+
+/* returns the 3 units (row, column, block) of a given cell */
+static inline const cell_id_t *units_of_cell(const units_t *units,
+                                             const size_t cell_id) {
+  return units->cell_units + cell_id * 3;
+}
+
+/* returns the positions of a given cell in its 3 units */
+static inline const cell_id_t *units_positions_of_cell(const units_t *units,
+                                                       const size_t cell_id) {
+  return units->cell_positions + cell_id * 3;
+}
+
+#endif /* UNITS_H */
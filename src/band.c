@@ -0,0 +1,291 @@
+#include "band.h"
+#include "colors.h"
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A band holds the rows 3b, 3b + 1 and 3b + 2 of the grid, the cell (r, c)
+ * being the bit (r % 3) * 9 + c of the band r / 3. */
+#define BAND_CELLS 0x7ffffff
+
+/* the cells of a row, of a column and of a block inside a band */
+static const uint32_t row_masks[3] = {0x1ff, 0x1ff << 9, 0x1ff << 18};
+static const uint32_t column_masks[9] = {
+    0x40201 << 0, 0x40201 << 1, 0x40201 << 2, 0x40201 << 3, 0x40201 << 4,
+    0x40201 << 5, 0x40201 << 6, 0x40201 << 7, 0x40201 << 8};
+static const uint32_t block_masks[3] = {0x1c0e07 << 0, 0x1c0e07 << 3,
+                                        0x1c0e07 << 6};
+
+/* the cells where each color may still go, band by band, and the cells not
+ * placed yet */
+typedef struct {
+  uint32_t colors[9][3];
+  uint32_t unsolved[3];
+} band_state_t;
+
+/* place a color in a cell of a band: the cell leaves the other colors and its
+ * row, column and block leave the color */
+static void band_place(band_state_t *state, const size_t color_id,
+                       const size_t band, const size_t bit_id) {
+  uint32_t bit = (uint32_t)1 << bit_id;
+  for (size_t k = 0; k < 9; k++) {
+    state->colors[k][band] &= ~bit;
+  }
+  uint32_t *color = state->colors[color_id];
+  uint32_t column = column_masks[bit_id % 9];
+  color[0] &= ~column;
+  color[1] &= ~column;
+  color[2] &= ~column;
+  color[band] &= ~(row_masks[bit_id / 9] | block_masks[bit_id % 9 / 3]);
+  color[band] |= bit;
+  state->unsolved[band] &= ~bit;
+}
+
+/* the color of an unsolved cell with a single candidate, 9 if it has none */
+static size_t band_single_color(const band_state_t *state, const size_t band,
+                                const uint32_t bit) {
+  size_t color_id = 0;
+  while (color_id < 9 && (state->colors[color_id][band] & bit) == 0) {
+    color_id++;
+  }
+  return color_id;
+}
+
+/* place the naked singles of the bands, returns false if a cell has no
+ * candidate left. progress is set if a color has been placed. */
+static bool band_naked_singles(band_state_t *state, bool *progress) {
+  for (size_t band = 0; band < 3; band++) {
+    uint32_t once = 0;
+    uint32_t twice = 0;
+    for (size_t k = 0; k < 9; k++) {
+      twice |= once & state->colors[k][band];
+      once |= state->colors[k][band];
+    }
+    if (once != BAND_CELLS) {
+      return false;
+    }
+    uint32_t singles = once & ~twice & state->unsolved[band];
+    while (singles != 0) {
+      size_t bit_id = colors_rightmost_id(singles);
+      singles &= singles - 1;
+      size_t color_id = band_single_color(state, band, (uint32_t)1 << bit_id);
+      /* an earlier single of the band may have emptied the cell */
+      if (color_id == 9) {
+        return false;
+      }
+      band_place(state, color_id, band, bit_id);
+      *progress = true;
+    }
+  }
+  return true;
+}
+
+/* place a color alone in a unit (its positions in the given band) if the
+ * cell is not placed yet, returns false if the unit has no position left */
+static bool band_hidden_single(band_state_t *state, const size_t color_id,
+                               const size_t band, const uint32_t positions,
+                               bool *progress) {
+  if (positions == 0) {
+    return false;
+  }
+  if (colors_is_singleton(positions) &&
+      (positions & state->unsolved[band]) != 0) {
+    band_place(state, color_id, band, colors_rightmost_id(positions));
+    *progress = true;
+  }
+  return true;
+}
+
+/* place the hidden singles of the rows, columns and blocks, returns false if
+ * a color has no position left in a unit. the placed cells of a color are in
+ * distinct rows, columns and blocks: once the color is only on placed cells,
+ * it is in every unit it should be if it is on each row. */
+static bool band_hidden_singles(band_state_t *state, bool *progress) {
+  for (size_t color_id = 0; color_id < 9; color_id++) {
+    const uint32_t *color = state->colors[color_id];
+    uint32_t unsolved = 0;
+    for (size_t band = 0; band < 3; band++) {
+      if ((color[band] & state->unsolved[band]) == 0) {
+        if ((color[band] & row_masks[0]) == 0 ||
+            (color[band] & row_masks[1]) == 0 ||
+            (color[band] & row_masks[2]) == 0) {
+          return false;
+        }
+        continue;
+      }
+      unsolved |= color[band] & state->unsolved[band];
+      for (size_t k = 0; k < 3; k++) {
+        if (!band_hidden_single(state, color_id, band,
+                                color[band] & row_masks[k], progress) ||
+            !band_hidden_single(state, color_id, band,
+                                color[band] & block_masks[k], progress)) {
+          return false;
+        }
+      }
+    }
+    if (unsolved == 0) {
+      continue;
+    }
+    for (size_t column = 0; column < 9; column++) {
+      uint32_t mask = column_masks[column];
+      /* the 9 cells of the column side by side, the bits 0, 9 and 18 of
+       * each band shifted by the band */
+      uint32_t positions = ((color[0] & mask) >> column) |
+                           ((color[1] & mask) >> column << 1) |
+                           ((color[2] & mask) >> column << 2);
+      if (positions == 0) {
+        return false;
+      }
+      if (colors_is_singleton(positions)) {
+        size_t band = colors_rightmost_id(positions) % 9;
+        band_hidden_single(state, color_id, band, color[band] & mask,
+                           progress);
+      }
+    }
+  }
+  return true;
+}
+
+/* place the singles until none is left, returns false on a contradiction */
+static bool band_propagate(band_state_t *state) {
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    if (!band_naked_singles(state, &progress)) {
+      return false;
+    }
+    if (!progress && !band_hidden_singles(state, &progress)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* the unsolved cell with the fewest candidates, as its band and bit */
+static void band_choose_cell(const band_state_t *state, size_t *band_ptr,
+                             size_t *bit_ptr) {
+  size_t best_count = 10;
+  for (size_t band = 0; band < 3; band++) {
+    uint32_t once = 0;
+    uint32_t twice = 0;
+    uint32_t thrice = 0;
+    for (size_t k = 0; k < 9; k++) {
+      thrice |= twice & state->colors[k][band];
+      twice |= once & state->colors[k][band];
+      once |= state->colors[k][band];
+    }
+    uint32_t pairs = twice & ~thrice & state->unsolved[band];
+    if (pairs != 0) {
+      *band_ptr = band;
+      *bit_ptr = colors_rightmost_id(pairs);
+      return;
+    }
+    uint32_t unsolved = state->unsolved[band];
+    while (unsolved != 0) {
+      size_t bit_id = colors_rightmost_id(unsolved);
+      unsolved &= unsolved - 1;
+      size_t count = 0;
+      for (size_t k = 0; k < 9; k++) {
+        count += (state->colors[k][band] >> bit_id) & 1;
+      }
+      if (count < best_count) {
+        best_count = count;
+        *band_ptr = band;
+        *bit_ptr = bit_id;
+      }
+    }
+  }
+}
+
+/* solve a state, which holds the solution if there is one */
+static bool band_search(band_state_t *state) {
+  if (!band_propagate(state)) {
+    return false;
+  }
+  if ((state->unsolved[0] | state->unsolved[1] | state->unsolved[2]) == 0) {
+    return true;
+  }
+
+  size_t band = 0;
+  size_t bit_id = 0;
+  band_choose_cell(state, &band, &bit_id);
+  for (size_t color_id = 0; color_id < 9; color_id++) {
+    if ((state->colors[color_id][band] >> bit_id) & 1) {
+      band_state_t child = *state;
+      band_place(&child, color_id, band, bit_id);
+      if (band_search(&child)) {
+        *state = child;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* the color of each cell of a solved state, as an index in color_table */
+static size_t band_cell_color(const band_state_t *state, const size_t row,
+                              const size_t column) {
+  uint32_t bit = (uint32_t)1 << ((row % 3) * 9 + column);
+  return band_single_color(state, row / 3, bit);
+}
+
+size_t band_solve(grid_t *grid) {
+  if (grid == NULL) {
+    return 2;
+  }
+  if (grid_get_size(grid) != 9) {
+    return grid_solve(grid);
+  }
+
+  band_state_t state = {{{0}}, {BAND_CELLS, BAND_CELLS, BAND_CELLS}};
+  for (size_t row = 0; row < 9; row++) {
+    for (size_t column = 0; column < 9; column++) {
+      uint32_t bit = (uint32_t)1 << ((row % 3) * 9 + column);
+      colors_foreach(color_id, grid_get_colors(grid, row, column)) {
+        state.colors[color_id][row / 3] |= bit;
+      }
+    }
+  }
+
+  if (!band_search(&state)) {
+    return 2;
+  }
+  for (size_t row = 0; row < 9; row++) {
+    for (size_t column = 0; column < 9; column++) {
+      grid_set_cell(grid, row, column,
+                    color_table[band_cell_color(&state, row, column)]);
+    }
+  }
+  return 0;
+}
+
+size_t band_solve_cells(char cells[81]) {
+  band_state_t state = {{{0}}, {BAND_CELLS, BAND_CELLS, BAND_CELLS}};
+  for (size_t cell_id = 0; cell_id < 81; cell_id++) {
+    size_t row = cell_id / 9;
+    uint32_t bit = (uint32_t)1 << ((row % 3) * 9 + cell_id % 9);
+    if (cells[cell_id] == EMPTY_CELL) {
+      for (size_t color_id = 0; color_id < 9; color_id++) {
+        state.colors[color_id][row / 3] |= bit;
+      }
+      continue;
+    }
+    const char *color = memchr(color_table, cells[cell_id], 9);
+    if (cells[cell_id] == '\0' || color == NULL) {
+      return 2;
+    }
+    state.colors[color - color_table][row / 3] |= bit;
+  }
+
+  if (!band_search(&state)) {
+    return 2;
+  }
+  for (size_t cell_id = 0; cell_id < 81; cell_id++) {
+    cells[cell_id] =
+        color_table[band_cell_color(&state, cell_id / 9, cell_id % 9)];
+  }
+  return 0;
+}
@@ -0,0 +1,184 @@
+#include "batch.h"
+#include "band.h"
+#include "colors.h"
+#include "grid.h"
+#include "units.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define BATCH_SIZE 9
+#define BATCH_CELLS (BATCH_SIZE * BATCH_SIZE)
+#define BATCH_FULL 0x1ff
+
+/* the lane loops below are written to be vectorized by the compiler, 16
+ * lanes of 16 bits being one AVX2 register. where the loader supports it,
+ * the sweep is compiled twice and the AVX2 version is picked at run time. */
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__linux__)
+#define BATCH_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define BATCH_TARGETS
+#endif
+
+/* the candidates of each cell, lane by lane */
+typedef uint16_t batch_cells_t[BATCH_CELLS][BATCH_LANES];
+
+/* one sweep of cross-hatching then of lone numbers over each unit, on all the
+ * lanes at once. returns true if a lane changed. */
+BATCH_TARGETS static bool batch_sweep(batch_cells_t cells,
+                                      const units_t *units) {
+  uint16_t changed[BATCH_LANES] = {0};
+  for (size_t unit_id = 0; unit_id < units->nb_units; unit_id++) {
+    const cell_id_t *cell_ids = units_cells(units, unit_id);
+
+    /* the singletons of the unit, and those seen twice */
+    uint16_t once[BATCH_LANES] = {0};
+    uint16_t twice[BATCH_LANES] = {0};
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      const uint16_t *cell = cells[cell_ids[i]];
+      for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+        uint16_t x = cell[lane];
+        uint16_t single = (x & (x - 1)) == 0 ? x : 0;
+        twice[lane] |= once[lane] & single;
+        once[lane] |= single;
+      }
+    }
+    /* cross-hatching: a cell loses the singletons of the other cells, a
+     * singleton seen twice empties both cells */
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      uint16_t *cell = cells[cell_ids[i]];
+      for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+        uint16_t x = cell[lane];
+        uint16_t single = (x & (x - 1)) == 0 ? x : 0;
+        uint16_t others = (once[lane] & ~single) | (twice[lane] & single);
+        uint16_t y = x & ~others;
+        changed[lane] |= x ^ y;
+        cell[lane] = y;
+      }
+    }
+
+    /* lone numbers: a color seen in a single cell is placed there, a cell
+     * with two of them is emptied */
+    uint16_t seen[BATCH_LANES] = {0};
+    uint16_t seen_twice[BATCH_LANES] = {0};
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      const uint16_t *cell = cells[cell_ids[i]];
+      for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+        seen_twice[lane] |= seen[lane] & cell[lane];
+        seen[lane] |= cell[lane];
+      }
+    }
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      uint16_t *cell = cells[cell_ids[i]];
+      for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+        uint16_t x = cell[lane];
+        uint16_t lone = x & ~seen_twice[lane];
+        uint16_t y = lone == 0 ? x : (lone & (lone - 1)) == 0 ? lone : 0;
+        changed[lane] |= x ^ y;
+        cell[lane] = y;
+      }
+    }
+  }
+
+  uint16_t any = 0;
+  for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+    any |= changed[lane];
+  }
+  return any != 0;
+}
+
+/* the status of a lane after the propagation: 2 if a cell is empty or a
+ * color can't go anywhere in a unit, 0 if every cell is a singleton, 1
+ * otherwise */
+static size_t batch_lane_status(batch_cells_t cells, const units_t *units,
+                                const size_t lane) {
+  for (size_t unit_id = 0; unit_id < units->nb_units; unit_id++) {
+    const cell_id_t *cell_ids = units_cells(units, unit_id);
+    uint16_t colors = 0;
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+      colors |= cells[cell_ids[i]][lane];
+    }
+    if (colors != BATCH_FULL) {
+      return 2;
+    }
+  }
+
+  size_t status = 0;
+  for (size_t cell_id = 0; cell_id < BATCH_CELLS; cell_id++) {
+    uint16_t x = cells[cell_id][lane];
+    if (x == 0) {
+      return 2;
+    }
+    if ((x & (x - 1)) != 0) {
+      status = 1;
+    }
+  }
+  return status;
+}
+
+/* propagate up to BATCH_LANES 9x9 grids together, then finish each of them */
+static void batch_solve_lanes(grid_t *grids[], size_t statuses[],
+                              const size_t nb_grids, const units_t *units) {
+  batch_cells_t cells;
+  for (size_t cell_id = 0; cell_id < BATCH_CELLS; cell_id++) {
+    size_t row = cell_id / BATCH_SIZE;
+    size_t column = cell_id % BATCH_SIZE;
+    for (size_t lane = 0; lane < BATCH_LANES; lane++) {
+      /* the unused lanes are left without singletons, they never change */
+      cells[cell_id][lane] =
+          lane < nb_grids ? grid_get_colors(grids[lane], row, column)
+                          : BATCH_FULL;
+    }
+  }
+
+  while (batch_sweep(cells, units)) {
+    continue;
+  }
+
+  for (size_t lane = 0; lane < nb_grids; lane++) {
+    statuses[lane] = batch_lane_status(cells, units, lane);
+    if (statuses[lane] == 2) {
+      continue;
+    }
+    for (size_t cell_id = 0; cell_id < BATCH_CELLS; cell_id++) {
+      grid_set_colors(grids[lane], cell_id / BATCH_SIZE, cell_id % BATCH_SIZE,
+                      cells[cell_id][lane]);
+    }
+    /* the lanes which need branching are searched one by one */
+    if (statuses[lane] == 1) {
+      statuses[lane] = band_solve(grids[lane]);
+    }
+  }
+}
+
+void batch_solve(grid_t *grids[], size_t statuses[], const size_t nb_grids) {
+  const units_t *units = units_get(BATCH_SIZE);
+  grid_t *lanes[BATCH_LANES];
+  size_t lane_ids[BATCH_LANES];
+  size_t lane_statuses[BATCH_LANES];
+  size_t nb_lanes = 0;
+  for (size_t i = 0; i <= nb_grids; i++) {
+    /* the lanes are solved once they are all used, and after the last grid */
+    if (nb_lanes == BATCH_LANES || (i == nb_grids && nb_lanes > 0)) {
+      batch_solve_lanes(lanes, lane_statuses, nb_lanes, units);
+      for (size_t lane = 0; lane < nb_lanes; lane++) {
+        statuses[lane_ids[lane]] = lane_statuses[lane];
+      }
+      nb_lanes = 0;
+    }
+    if (i == nb_grids) {
+      break;
+    }
+
+    if (grids[i] == NULL) {
+      statuses[i] = 2;
+    } else if (grid_get_size(grids[i]) != BATCH_SIZE) {
+      statuses[i] = grid_solve(grids[i]);
+    } else {
+      lanes[nb_lanes] = grids[i];
+      lane_ids[nb_lanes] = i;
+      nb_lanes++;
+    }
+  }
+}
@@ -0,0 +1,691 @@
+#include "bitplane.h"
+#include "colors.h"
+#include "grid.h"
+#include "units.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <err.h>
+#include <string.h>
+
+/* Bitboards of a grid of size n hold one bit per cell, each row starting on a
+ * word: the cell (r, c) is the bit c % 64 of the word r * row_words + c / 64.
+ * The rows of a column or of a band of blocks are then folded word by word.
+ * A state is n + 1 bitboards, the planes of the n colors then the placed
+ * cells, followed by the number of candidates of each cell (one byte each). */
+typedef struct {
+  size_t size;
+  size_t block_size;
+  size_t nb_cells;
+  /* words of a row, of a bitboard and of a state */
+  size_t row_words;
+  size_t nb_words;
+  size_t state_words;
+  /* cells of the rows, columns and blocks */
+  const units_t *units;
+  /* bitboard of all the cells of the grid */
+  uint64_t *cells;
+  /* cells with at least 1, 2 and 3 candidates, recomputed by count() */
+  uint64_t *once;
+  uint64_t *twice;
+  uint64_t *thrice;
+  /* the columns of each stack of blocks, row_words words per stack */
+  uint64_t *stacks;
+  /* the color with the fewest positions (2 at least) in a unit, recorded by
+   * the last hidden singles pass */
+  size_t best_unit;
+  size_t best_color;
+  size_t best_positions;
+  /* one state per level of the search, allocated on demand */
+  uint64_t **states;
+  size_t nb_states;
+} bitplane_t;
+
+/* rows, columns and blocks folded along their cells: the bits with at least
+ * 1, 2 and 3 positions, and with at least 1 position on a cell not placed */
+typedef struct {
+  uint64_t *once;
+  uint64_t *twice;
+  uint64_t *thrice;
+  uint64_t *unplaced;
+} bitplane_fold_t;
+
+static uint64_t *bitplane_plane(const bitplane_t *bp, uint64_t *state,
+                                const size_t color_id) {
+  return state + color_id * bp->nb_words;
+}
+
+static uint64_t *bitplane_placed(const bitplane_t *bp, uint64_t *state) {
+  return state + bp->size * bp->nb_words;
+}
+
+static uint8_t *bitplane_counts(const bitplane_t *bp, uint64_t *state) {
+  return (uint8_t *)(state + (bp->size + 1) * bp->nb_words);
+}
+
+static size_t bitplane_word(const bitplane_t *bp, const size_t cell) {
+  return (cell / bp->size) * bp->row_words + (cell % bp->size) / 64;
+}
+
+static uint64_t bitplane_bit(const bitplane_t *bp, const size_t cell) {
+  return (uint64_t)1 << (cell % bp->size % 64);
+}
+
+/* the cell of a bit of a word */
+static size_t bitplane_cell(const bitplane_t *bp, const size_t word,
+                            const size_t bit) {
+  return (word / bp->row_words) * bp->size + (word % bp->row_words) * 64 +
+         bit;
+}
+
+static bool bitplane_has(const bitplane_t *bp, const uint64_t *board,
+                         const size_t cell) {
+  return (board[bitplane_word(bp, cell)] & bitplane_bit(bp, cell)) != 0;
+}
+
+static size_t bitplane_count_words(const uint64_t *words, const size_t length) {
+  size_t count = 0;
+  for (size_t i = 0; i < length; i++) {
+    count += colors_count(words[i]);
+  }
+  return count;
+}
+
+static void bitplane_init(bitplane_t *bp, const grid_t *grid) {
+  size_t size = grid_get_size(grid);
+  bp->size = size;
+  bp->units = units_get(size);
+  bp->block_size = bp->units->block_size;
+  bp->nb_cells = size * size;
+  bp->row_words = (size + 63) / 64;
+  bp->nb_words = size * bp->row_words;
+  bp->state_words = (size + 1) * bp->nb_words + (bp->nb_cells + 7) / 8;
+
+  size_t nb_words = bp->nb_words;
+  size_t bs = bp->block_size;
+  bp->cells = calloc(4 * nb_words + bs * bp->row_words, sizeof(uint64_t));
+  bp->states = malloc(sizeof(uint64_t *));
+  if (bp->cells == NULL || bp->states == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the bitplanes of the grid.");
+  }
+  bp->once = bp->cells + nb_words;
+  bp->twice = bp->once + nb_words;
+  bp->thrice = bp->twice + nb_words;
+  bp->stacks = bp->thrice + nb_words;
+
+  for (size_t cell = 0; cell < bp->nb_cells; cell++) {
+    bp->cells[bitplane_word(bp, cell)] |= bitplane_bit(bp, cell);
+  }
+  for (size_t column = 0; column < size; column++) {
+    bp->stacks[(column / bs) * bp->row_words + column / 64] |=
+        bitplane_bit(bp, column);
+  }
+
+  /* the first state holds the candidates of the grid, nothing is placed */
+  bp->nb_states = 1;
+  bp->states[0] = calloc(bp->state_words, sizeof(uint64_t));
+  if (bp->states[0] == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the bitplanes of the grid.");
+  }
+  uint8_t *counts = bitplane_counts(bp, bp->states[0]);
+  for (size_t cell = 0; cell < bp->nb_cells; cell++) {
+    for (size_t color_id = 0; color_id < size; color_id++) {
+      if (grid_has_color(grid, cell / size, cell % size, color_id)) {
+        bitplane_plane(bp, bp->states[0], color_id)[bitplane_word(bp, cell)] |=
+            bitplane_bit(bp, cell);
+        counts[cell]++;
+      }
+    }
+  }
+}
+
+static void bitplane_free(bitplane_t *bp) {
+  for (size_t i = 0; i < bp->nb_states; i++) {
+    free(bp->states[i]);
+  }
+  free(bp->states);
+  free(bp->cells);
+}
+
+/* the state of a level of the search, allocated the first time it is used */
+static uint64_t *bitplane_state(bitplane_t *bp, const size_t depth) {
+  if (depth == bp->nb_states) {
+    bp->states = realloc(bp->states, (depth + 1) * sizeof(uint64_t *));
+    if (bp->states == NULL) {
+      errx(EXIT_FAILURE, "can't grow the bitplanes of the search.");
+    }
+    bp->states[depth] = malloc(bp->state_words * sizeof(uint64_t));
+    if (bp->states[depth] == NULL) {
+      errx(EXIT_FAILURE, "can't grow the bitplanes of the search.");
+    }
+    bp->nb_states++;
+  }
+  return bp->states[depth];
+}
+
+/* remove a color from the cells of a mask in a word of its plane, the
+ * candidates of these cells are counted down. returns true if a cell lost
+ * it. */
+static bool bitplane_eliminate(const bitplane_t *bp, uint64_t *state,
+                               const size_t color_id, const size_t word,
+                               const uint64_t mask) {
+  uint64_t *plane = bitplane_plane(bp, state, color_id);
+  uint64_t removed = plane[word] & mask;
+  if (removed == 0) {
+    return false;
+  }
+
+  plane[word] &= ~mask;
+  uint8_t *counts = bitplane_counts(bp, state);
+  while (removed != 0) {
+    counts[bitplane_cell(bp, word, colors_rightmost_id(removed))]--;
+    removed &= removed - 1;
+  }
+  return true;
+}
+
+/* place a color in a cell: the cell leaves the other planes and the units of
+ * the cell leave the plane of the color. returns false if the color was not a
+ * candidate of the cell. */
+static bool bitplane_place(const bitplane_t *bp, uint64_t *state,
+                           const size_t color_id, const size_t cell) {
+  uint64_t *plane = bitplane_plane(bp, state, color_id);
+  if (!bitplane_has(bp, plane, cell)) {
+    return false;
+  }
+
+  size_t size = bp->size;
+  size_t row_words = bp->row_words;
+  size_t word = bitplane_word(bp, cell);
+  uint64_t bit = bitplane_bit(bp, cell);
+  for (size_t k = 0; k < size; k++) {
+    bitplane_eliminate(bp, state, k, word, bit);
+  }
+  size_t row = cell / size;
+  size_t column = cell % size;
+  for (size_t w = 0; w < row_words; w++) {
+    bitplane_eliminate(bp, state, color_id, row * row_words + w, ~0ULL);
+  }
+  for (size_t r = 0; r < size; r++) {
+    bitplane_eliminate(bp, state, color_id, r * row_words + column / 64, bit);
+  }
+  size_t bs = bp->block_size;
+  const uint64_t *stack = bp->stacks + (column / bs) * row_words;
+  for (size_t r = row - row % bs; r < row - row % bs + bs; r++) {
+    for (size_t w = 0; w < row_words; w++) {
+      bitplane_eliminate(bp, state, color_id, r * row_words + w, stack[w]);
+    }
+  }
+  plane[word] |= bit;
+  bitplane_placed(bp, state)[word] |= bit;
+  bitplane_counts(bp, state)[cell] = 1;
+  return true;
+}
+
+/* gather the cells with at least 1, 2 and 3 candidates, returns false if a
+ * cell has none */
+static bool bitplane_count(bitplane_t *bp, uint64_t *state) {
+  size_t nb_words = bp->nb_words;
+  for (size_t w = 0; w < nb_words; w++) {
+    uint64_t once = 0;
+    uint64_t twice = 0;
+    uint64_t thrice = 0;
+    for (size_t k = 0; k < bp->size; k++) {
+      uint64_t plane = bitplane_plane(bp, state, k)[w];
+      thrice |= twice & plane;
+      twice |= once & plane;
+      once |= plane;
+    }
+    if ((bp->cells[w] & ~once) != 0) {
+      return false;
+    }
+    bp->once[w] = once;
+    bp->twice[w] = twice;
+    bp->thrice[w] = thrice;
+  }
+  return true;
+}
+
+/* fold the rows first..first+length of a plane, column by column */
+static void bitplane_fold(const bitplane_t *bp, const uint64_t *plane,
+                          const uint64_t *placed, const size_t first,
+                          const size_t length, bitplane_fold_t *fold) {
+  size_t row_words = bp->row_words;
+  for (size_t w = 0; w < row_words; w++) {
+    fold->once[w] = 0;
+    fold->twice[w] = 0;
+    fold->thrice[w] = 0;
+    fold->unplaced[w] = 0;
+  }
+  for (size_t r = first; r < first + length; r++) {
+    for (size_t w = 0; w < row_words; w++) {
+      uint64_t positions = plane[r * row_words + w];
+      fold->thrice[w] |= fold->twice[w] & positions;
+      fold->twice[w] |= fold->once[w] & positions;
+      fold->once[w] |= positions;
+      fold->unplaced[w] |= positions & ~placed[r * row_words + w];
+    }
+  }
+}
+
+/* record the positions of a color in a unit if they are the fewest so far */
+static void bitplane_offer(bitplane_t *bp, const size_t unit_id,
+                           const size_t color_id, const size_t count) {
+  if (count > 1 && count < bp->best_positions) {
+    bp->best_unit = unit_id;
+    bp->best_color = color_id;
+    bp->best_positions = count;
+  }
+}
+
+/* place a color on the single cell of a unit where it lies on the rows
+ * first..first+length, at a column of the mask. returns false if the cell
+ * can't take it. */
+static bool bitplane_place_single(const bitplane_t *bp, uint64_t *state,
+                                  const size_t color_id, const size_t first,
+                                  const size_t length, const uint64_t *mask) {
+  const uint64_t *plane = bitplane_plane(bp, state, color_id);
+  for (size_t r = first; r < first + length; r++) {
+    for (size_t w = 0; w < bp->row_words; w++) {
+      uint64_t positions = plane[r * bp->row_words + w] & mask[w];
+      if (positions != 0) {
+        size_t cell = r * bp->size + w * 64 + colors_rightmost_id(positions);
+        return bitplane_place(bp, state, color_id, cell);
+      }
+    }
+  }
+  return false;
+}
+
+/* the hidden singles of a color: its single position in a row, a column or a
+ * block. the columns and the blocks are counted on the folds of their rows,
+ * up to 3 positions. returns false on a contradiction, *changed is set if a
+ * color is placed. */
+static bool bitplane_hidden_singles(bitplane_t *bp, uint64_t *state,
+                                    const size_t color_id, bool *changed) {
+  size_t size = bp->size;
+  size_t bs = bp->block_size;
+  size_t row_words = bp->row_words;
+  const uint64_t *plane = bitplane_plane(bp, state, color_id);
+  const uint64_t *placed = bitplane_placed(bp, state);
+
+  for (size_t row = 0; row < size; row++) {
+    const uint64_t *positions = plane + row * row_words;
+    size_t count = bitplane_count_words(positions, row_words);
+    if (count == 0) {
+      return false;
+    }
+    if (count == 1) {
+      size_t w = 0;
+      while (positions[w] == 0) {
+        w++;
+      }
+      size_t cell = bitplane_cell(bp, row * row_words + w,
+                                  colors_rightmost_id(positions[w]));
+      if (!bitplane_has(bp, placed, cell)) {
+        if (!bitplane_place(bp, state, color_id, cell)) {
+          return false;
+        }
+        *changed = true;
+      }
+    }
+    bitplane_offer(bp, row, color_id, count);
+  }
+
+  uint64_t words[4 * row_words];
+  bitplane_fold_t fold = {words, words + row_words, words + 2 * row_words,
+                          words + 3 * row_words};
+  uint64_t singles[row_words];
+  bitplane_fold(bp, plane, placed, 0, size, &fold);
+  for (size_t w = 0; w < row_words; w++) {
+    if ((bp->cells[w] & ~fold.once[w]) != 0) {
+      return false;
+    }
+  }
+  for (size_t w = 0; w < row_words; w++) {
+    singles[w] = fold.once[w] & ~fold.twice[w] & fold.unplaced[w];
+    uint64_t pairs = fold.twice[w] & ~fold.thrice[w];
+    if (pairs != 0) {
+      bitplane_offer(bp, size + w * 64 + colors_rightmost_id(pairs), color_id,
+                     2);
+    }
+  }
+  for (size_t w = 0; w < row_words; w++) {
+    while (singles[w] != 0) {
+      uint64_t column[row_words];
+      memset(column, 0, sizeof(column));
+      column[w] = colors_rightmost(singles[w]);
+      singles[w] &= singles[w] - 1;
+      if (!bitplane_place_single(bp, state, color_id, 0, size, column)) {
+        return false;
+      }
+      *changed = true;
+    }
+  }
+
+  for (size_t band = 0; band < size; band += bs) {
+    bitplane_fold(bp, plane, placed, band, bs, &fold);
+    for (size_t s = 0; s < bs; s++) {
+      const uint64_t *stack = bp->stacks + s * row_words;
+      size_t columns = 0;
+      size_t doubled = 0;
+      bool tripled = false;
+      bool unplaced = false;
+      for (size_t w = 0; w < row_words; w++) {
+        columns += colors_count(fold.once[w] & stack[w]);
+        doubled += colors_count(fold.twice[w] & stack[w]);
+        tripled |= (fold.thrice[w] & stack[w]) != 0;
+        unplaced |= (fold.unplaced[w] & stack[w]) != 0;
+      }
+      if (columns == 0) {
+        return false;
+      }
+      if (columns == 1 && doubled == 0 && unplaced) {
+        if (!bitplane_place_single(bp, state, color_id, band, bs, stack)) {
+          return false;
+        }
+        *changed = true;
+      } else if (!tripled && columns + doubled == 2) {
+        bitplane_offer(bp, 2 * size + band + s, color_id, 2);
+      }
+    }
+  }
+  return true;
+}
+
+/* place the naked singles, then the hidden singles, until none is left.
+ * returns false on a contradiction. */
+static bool bitplane_propagate(bitplane_t *bp, uint64_t *state) {
+  size_t size = bp->size;
+  size_t nb_words = bp->nb_words;
+  const uint64_t *placed = bitplane_placed(bp, state);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    if (!bitplane_count(bp, state)) {
+      return false;
+    }
+    for (size_t w = 0; w < nb_words; w++) {
+      uint64_t singles = bp->once[w] & ~bp->twice[w] & ~placed[w];
+      while (singles != 0) {
+        size_t cell = bitplane_cell(bp, w, colors_rightmost_id(singles));
+        singles &= singles - 1;
+        size_t color_id = 0;
+        while (color_id < size &&
+               !bitplane_has(bp, bitplane_plane(bp, state, color_id), cell)) {
+          color_id++;
+        }
+        /* an earlier single of the pass may have emptied the cell */
+        if (color_id == size || !bitplane_place(bp, state, color_id, cell)) {
+          return false;
+        }
+        changed = true;
+      }
+    }
+    if (changed) {
+      continue;
+    }
+
+    bp->best_positions = size + 1;
+    for (size_t color_id = 0; color_id < size; color_id++) {
+      if (!bitplane_hidden_singles(bp, state, color_id, &changed)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* pointing: the positions of a color in a block lying on a single row (or
+ * column) are removed from the rest of the line. returns true if a plane
+ * changed. */
+static bool bitplane_pointing(bitplane_t *bp, uint64_t *state) {
+  size_t size = bp->size;
+  size_t row_words = bp->row_words;
+  size_t bs = bp->block_size;
+  bool changed = false;
+  for (size_t color_id = 0; color_id < size; color_id++) {
+    const uint64_t *plane = bitplane_plane(bp, state, color_id);
+    for (size_t band = 0; band < size; band += bs) {
+      for (size_t s = 0; s < bs; s++) {
+        const uint64_t *stack = bp->stacks + s * row_words;
+        uint64_t columns[row_words];
+        memset(columns, 0, sizeof(columns));
+        size_t nb_rows = 0;
+        size_t row = 0;
+        for (size_t r = band; r < band + bs; r++) {
+          uint64_t any = 0;
+          for (size_t w = 0; w < row_words; w++) {
+            uint64_t positions = plane[r * row_words + w] & stack[w];
+            columns[w] |= positions;
+            any |= positions;
+          }
+          if (any != 0) {
+            nb_rows++;
+            row = r;
+          }
+        }
+        size_t nb_columns = bitplane_count_words(columns, row_words);
+        /* a single position is a hidden single, already placed */
+        if (nb_columns <= 1 && nb_rows <= 1) {
+          continue;
+        }
+
+        if (nb_rows == 1) {
+          for (size_t w = 0; w < row_words; w++) {
+            changed |= bitplane_eliminate(bp, state, color_id,
+                                          row * row_words + w, ~stack[w]);
+          }
+        } else if (nb_columns == 1) {
+          size_t w = 0;
+          while (columns[w] == 0) {
+            w++;
+          }
+          for (size_t r = 0; r < size; r++) {
+            if (r < band || r >= band + bs) {
+              changed |= bitplane_eliminate(bp, state, color_id,
+                                            r * row_words + w, columns[w]);
+            }
+          }
+        }
+      }
+    }
+  }
+  return changed;
+}
+
+/* claiming: the positions of a color in a row (or column) lying in a single
+ * block are removed from the rest of the block. returns true if a plane
+ * changed. */
+static bool bitplane_claiming(bitplane_t *bp, uint64_t *state) {
+  size_t size = bp->size;
+  size_t row_words = bp->row_words;
+  size_t bs = bp->block_size;
+  bool changed = false;
+  for (size_t color_id = 0; color_id < size; color_id++) {
+    const uint64_t *plane = bitplane_plane(bp, state, color_id);
+    /* the columns with positions in each band, then in several bands */
+    uint64_t bands[bs * row_words];
+    uint64_t shared[row_words];
+    memset(bands, 0, sizeof(bands));
+    memset(shared, 0, sizeof(shared));
+    for (size_t row = 0; row < size; row++) {
+      const uint64_t *positions = plane + row * row_words;
+      uint64_t *band = bands + (row / bs) * row_words;
+      size_t nb_stacks = 0;
+      size_t stack_id = 0;
+      for (size_t s = 0; s < bs && nb_stacks < 2; s++) {
+        const uint64_t *stack = bp->stacks + s * row_words;
+        for (size_t w = 0; w < row_words; w++) {
+          if ((positions[w] & stack[w]) != 0) {
+            nb_stacks++;
+            stack_id = s;
+            break;
+          }
+        }
+      }
+      for (size_t w = 0; w < row_words; w++) {
+        band[w] |= positions[w];
+      }
+      if (nb_stacks != 1) {
+        continue;
+      }
+
+      const uint64_t *stack = bp->stacks + stack_id * row_words;
+      for (size_t r = row - row % bs; r < row - row % bs + bs; r++) {
+        for (size_t w = 0; w < row_words && r != row; w++) {
+          changed |=
+              bitplane_eliminate(bp, state, color_id, r * row_words + w,
+                                 stack[w]);
+        }
+      }
+    }
+
+    for (size_t b = 0; b < bs; b++) {
+      for (size_t other = b + 1; other < bs; other++) {
+        for (size_t w = 0; w < row_words; w++) {
+          shared[w] |= bands[b * row_words + w] & bands[other * row_words + w];
+        }
+      }
+    }
+    for (size_t b = 0; b < bs; b++) {
+      for (size_t w = 0; w < row_words; w++) {
+        uint64_t columns = bands[b * row_words + w] & ~shared[w];
+        while (columns != 0) {
+          size_t column = w * 64 + colors_rightmost_id(columns);
+          uint64_t bit = colors_rightmost(columns);
+          columns &= columns - 1;
+          const uint64_t *stack = bp->stacks + (column / bs) * row_words;
+          for (size_t r = b * bs; r < b * bs + bs; r++) {
+            for (size_t v = 0; v < row_words; v++) {
+              uint64_t rest = v == w ? stack[v] & ~bit : stack[v];
+              changed |=
+                  bitplane_eliminate(bp, state, color_id, r * row_words + v,
+                                     rest);
+            }
+          }
+        }
+      }
+    }
+  }
+  return changed;
+}
+
+/* the unplaced cell with the fewest candidates and their number: a pair from
+ * the last bitplane_count(), otherwise the lowest count of the cells */
+static size_t bitplane_choose_cell(const bitplane_t *bp, uint64_t *state,
+                                   size_t *count_ptr) {
+  const uint64_t *placed = bitplane_placed(bp, state);
+  for (size_t w = 0; w < bp->nb_words; w++) {
+    uint64_t pairs = bp->twice[w] & ~bp->thrice[w] & ~placed[w];
+    if (pairs != 0) {
+      *count_ptr = 2;
+      return bitplane_cell(bp, w, colors_rightmost_id(pairs));
+    }
+  }
+
+  /* the placed cells are the only ones left with a single candidate */
+  const uint8_t *counts = bitplane_counts(bp, state);
+  size_t best_cell = 0;
+  size_t best_count = bp->size + 1;
+  for (size_t cell = 0; cell < bp->nb_cells; cell++) {
+    if (counts[cell] > 1 && counts[cell] < best_count) {
+      best_count = counts[cell];
+      best_cell = cell;
+    }
+  }
+  *count_ptr = best_count;
+  return best_cell;
+}
+
+/* try to solve the state of a level of the search with a color placed in a
+ * cell, the solution is copied back in the state of the level */
+static bool bitplane_search(bitplane_t *bp, const size_t depth);
+
+static bool bitplane_try(bitplane_t *bp, const size_t depth,
+                         const size_t color_id, const size_t cell) {
+  uint64_t *state = bp->states[depth];
+  uint64_t *child = bitplane_state(bp, depth + 1);
+  memcpy(child, state, bp->state_words * sizeof(uint64_t));
+  bitplane_place(bp, child, color_id, cell);
+  if (bitplane_search(bp, depth + 1)) {
+    memcpy(state, child, bp->state_words * sizeof(uint64_t));
+    return true;
+  }
+  return false;
+}
+
+/* solve the state of a level of the search, the solution is left in the
+ * state of the level */
+static bool bitplane_search(bitplane_t *bp, const size_t depth) {
+  uint64_t *state = bp->states[depth];
+  const uint64_t *placed = bitplane_placed(bp, state);
+  /* the singles are placed again as long as the pointing or the claiming
+   * removes positions */
+  do {
+    if (!bitplane_propagate(bp, state)) {
+      return false;
+    }
+    if (memcmp(placed, bp->cells, bp->nb_words * sizeof(uint64_t)) == 0) {
+      return true;
+    }
+  } while (bitplane_pointing(bp, state) | bitplane_claiming(bp, state));
+
+  /* branch on the cell with the fewest candidates, or on the positions of a
+   * color in a unit if there are fewer of them */
+  size_t count = 0;
+  size_t cell = bitplane_choose_cell(bp, state, &count);
+  if (bp->best_positions < count) {
+    size_t color_id = bp->best_color;
+    const uint64_t *plane = bitplane_plane(bp, state, color_id);
+    const cell_id_t *cells = units_cells(bp->units, bp->best_unit);
+    for (size_t i = 0; i < bp->size; i++) {
+      if (bitplane_has(bp, plane, cells[i]) &&
+          bitplane_try(bp, depth, color_id, cells[i])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  for (size_t color_id = 0; color_id < bp->size; color_id++) {
+    if (bitplane_has(bp, bitplane_plane(bp, state, color_id), cell) &&
+        bitplane_try(bp, depth, color_id, cell)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t bitplane_solve(grid_t *grid) {
+  if (grid == NULL) {
+    return 2;
+  }
+
+  /* the planes start from the candidates left by the heuristics */
+  size_t status = grid_heuristics(grid);
+  if (status != 1) {
+    return status;
+  }
+
+  bitplane_t bp;
+  bitplane_init(&bp, grid);
+  status = 2;
+  if (bitplane_search(&bp, 0)) {
+    size_t size = bp.size;
+    for (size_t cell = 0; cell < bp.nb_cells; cell++) {
+      for (size_t color_id = 0; color_id < size; color_id++) {
+        if (bitplane_has(&bp, bitplane_plane(&bp, bp.states[0], color_id),
+                         cell)) {
+          grid_set_cell(grid, cell / size, cell % size, color_table[color_id]);
+          break;
+        }
+      }
+    }
+    status = 0;
+  }
+  bitplane_free(&bp);
+  return status;
+}
@@ -1,4 +1,6 @@
 #include "colors.h"
+#include "colors_narrow.h"
+#include "colors_wide.h"
 #include "grid.h"
 
 #include <stdint.h>
@@ -8,247 +10,179 @@
 
 #include <inttypes.h>
 
-colors_t colors_full(const size_t size) {
-  if (size <= 63) {
-    return (((colors_t)1 << size) - 1);
-  }
-  return (((colors_t)1 << MAX_COLORS) - 1);
-}
-
-colors_t colors_empty(void) { return (colors_t)0; }
-
-colors_t colors_set(const size_t color_id) {
-  if (color_id < MAX_COLORS) {
-    return ((colors_t)1 << color_id);
-  }
-  return colors_empty();
-}
-
-colors_t colors_add(const colors_t colors, const size_t color_id) {
-  if (color_id < MAX_COLORS) {
-    return (colors_t)(colors | ((colors_t)1 << (color_id)));
-  }
-  return colors;
-}
-
-colors_t colors_discard(const colors_t colors, const size_t color_id) {
-  if (color_id < MAX_COLORS) {
-    return (colors ^ ((colors_t)1 << (color_id))) & colors;
-  }
-  return colors;
-}
-
-bool colors_is_in(const colors_t colors, const size_t color_id) {
-  if (color_id < MAX_COLORS) {
-    return (colors & ((colors_t)1 << color_id)) != 0;
-  }
-  return false;
-}
-
-colors_t colors_negate(const colors_t colors) { return ~colors; }
-
-colors_t colors_and(const colors_t colors1, const colors_t colors2) {
-  return (colors1 & colors2);
-}
-
-colors_t colors_or(const colors_t colors1, const colors_t colors2) {
-  return (colors1 | colors2);
-}
-
-colors_t colors_xor(const colors_t colors1, const colors_t colors2) {
-  return (colors1 ^ colors2);
-}
-
-colors_t colors_subtract(const colors_t colors1, const colors_t colors2) {
-  return colors1 ^ (colors1 & colors2);
-}
-
-bool colors_is_equal(const colors_t colors1, const colors_t colors2) {
-  return (colors1 ^ colors2) == 0;
-}
-
-bool colors_is_subset(const colors_t colors1, const colors_t colors2) {
-  if (colors1 == 0 || colors2 == 0) {
-    return false;
-  }
-  return (colors1 & colors2) == colors1;
-}
-
-bool colors_is_singleton(const colors_t colors) {
-  if (colors == 0) {
-    return false;
-  }
-
-  return (colors & (colors - 1)) == 0;
-}
-
-size_t colors_count(const colors_t colors) {
-  uint64_t y = colors;
-  y -= ((y >> 1) & 0x5555555555555555ull);
-  y = (y & 0x3333333333333333ull) + (y >> 2 & 0x3333333333333333ull);
-  return ((y + (y >> 4)) & 0xf0f0f0f0f0f0f0full) * 0x101010101010101ull >> 56;
-}
-
-colors_t colors_rightmost(const colors_t colors) {
-  return (colors & (-colors));
-}
-
-colors_t colors_leftmost(const colors_t colors) {
-  if (colors == 0) {
-    return colors_empty();
-  }
-  int pos = 0;
-  while ((colors >> pos) > 0 && pos < MAX_COLORS) {
-    pos++;
-  }
-  return colors_set(pos - 1);
-}
+/* heuristics run by subgrid_heuristics() and maximum size of the subsets */
+static unsigned selected_heuristics = HEURISTICS_DEFAULT;
+static size_t subset_max = SUBSET_MAX_DEFAULT;
 
 colors_t colors_random(const colors_t colors) {
   if (colors == 0) {
     return colors_empty();
   } else {
-    while (true) {
-      size_t r = rand() % 64;
-      if (colors_is_in(colors, r)) {
-        return (colors_set(r));
+    size_t r = rand() % colors_count(colors);
+    colors_foreach(color_id, colors) {
+      if (r-- == 0) {
+        return colors_set(color_id);
       }
     }
+    return colors_empty();
   }
 }
 
-bool subgrid_consistency(colors_t subgrid[], const size_t size) {
-  colors_t colors_seen = colors_full(size);
-  if (subgrid == NULL) {
-    return false;
-  }
-  // bool consistent = false;
-  for (size_t i = 0; i < size; i++) {
-    colors_t sub_cell = subgrid[i];
-    if (colors_count(subgrid[i] == 0)) {
-      return false;
-    }
-    if (colors_is_singleton(sub_cell)) {
-      for (size_t j = i + 1; j < size; j++) {
-        colors_t singleton_cell = subgrid[j];
-        if (colors_is_singleton(singleton_cell)) {
-          if (colors_is_equal(sub_cell, singleton_cell)) {
-            return false;
-          }
-        }
-      }
-    }
-    colors_seen = colors_subtract(colors_seen, sub_cell);
-  }
-  if (!colors_is_equal(colors_seen, colors_empty())) {
-    return false;
-  }
-  return true;
-}
+/* the reductions of a unit checked by subgrid_consistency(): the union of
+ * its cells and of its singletons, its number of singletons and whether one
+ * of its cells is empty */
+typedef struct {
+  colors_t colors;
+  colors_t singletons;
+  size_t nb_singletons;
+  bool empty;
+} unit_summary_t;
 
-static bool cross_hatching(colors_t *subgrid[], size_t size) {
-  bool cross_hatch = false;
+/* adds the cells of the subgrid to the summary, without branches so that the
+ * compiler may vectorize it */
+static void unit_summary(const colors_t subgrid[], const size_t size,
+                         unit_summary_t *summary) {
   for (size_t i = 0; i < size; i++) {
-    if (colors_is_singleton(*(subgrid[i]))) {
-      for (size_t j = 0; j < size; j++) {
-        if (i != j) {
-          if (*(subgrid[j]) == colors_subtract(*(subgrid[j]), *(subgrid[i]))) {
-
-          } else {
-            *(subgrid[j]) = colors_subtract(*(subgrid[j]), *(subgrid[i]));
-            cross_hatch = true;
-          }
-        }
-      }
-    }
+    colors_t cell = subgrid[i];
+    bool singleton = colors_is_singleton(cell);
+    summary->colors |= cell;
+    summary->singletons |= singleton ? cell : 0;
+    summary->nb_singletons += singleton;
+    summary->empty |= cell == 0;
   }
-  return cross_hatch;
 }
 
-static bool lone_number(colors_t *subgrid[], size_t size) {
-  /*bool lone_numb = false;
-  for (size_t i = 0; i < size; i++) {
-    colors_t subset = colors_full(size);
-    subset = colors_subtract(subset, *(subgrid[i]));
-    subset = colors_negate(subset);
-    for (size_t j = 0; j < size; j++) {
-      if (j != i) {
-        subset = colors_subtract(subset, *(subgrid[j]));
-      }
-    }
-    if (colors_count(subset) > 0) {
-      *(subgrid[i]) = colors_set(colors_leftmost(subset));
-      lone_numb = true;
-    }
-  }
-  return lone_numb;
-}*/
-  bool lone_numb = false;
-  for (size_t i = 0; i < size; i++) {
-    if (!colors_is_singleton(*(subgrid[i]))) {
-      for (size_t j = 0; j < size; j++) {
-        if (colors_is_in(*(subgrid[i]), j)) {
-          for (size_t k = 0; k < size; k++) {
-            if (colors_is_in(*(subgrid[k]), j) && k != i) {
-              return false;
-            }
-          }
-          *(subgrid[i]) = colors_set(j);
-          lone_numb = true;
-        }
-      }
-    }
+bool subgrid_consistency(colors_t subgrid[], const size_t size) {
+  if (subgrid == NULL) {
+    return false;
   }
-  return lone_numb;
-}
 
-/*static bool naked_subset(colors_t* subgrid[], size_t size)
-{
-    bool naked_sub = false;
-    for(size_t i = 0; i < size; i++)
-    {
-        if(!colors_is_singleton(*(subgrid[i])))
-        {
-            for(size_t j = 0; j < size; j++)
-            {
-                if(colors_is_subset(*(subgrid[i]), *(subgrid[j])))
-                {
-                    *(subgrid[j]) = colors_subtract(*(subgrid[j]),
-*(subgrid[i])); naked_sub = true;
-                }
-            }
-        }
-    }
-    return naked_sub;
-}*/
+  unit_summary_t summary = {colors_empty(), colors_empty(), 0, false};
+  unit_summary(subgrid, size, &summary);
 
-static bool naked_subset(colors_t *subgrid[], size_t size) {
-  bool naked_sub = false;
-  for (size_t i = 0; i < size; i++) {
-    if (!colors_is_singleton(*(subgrid[i]))) {
-      for (size_t j = 0; j < size; j++) {
-        if (j != i && colors_is_equal(*(subgrid[i]), *(subgrid[j]))) {
-          for (size_t k = 0; k < size; k++) {
-            if (k != j && k != i) {
-              if (*subgrid[k] == colors_discard(*subgrid[k], *(subgrid[i]))) {
-
-              } else {
-                *(subgrid[k]) = colors_discard(*(subgrid[k]), *(subgrid[i]));
-                naked_sub = true;
-              }
-            }
-          }
-        }
-      }
-    }
+  /* two equal singletons are counted twice but seen once in the union */
+  if (summary.empty ||
+      colors_count(summary.singletons) != summary.nb_singletons) {
+    return false;
   }
-  return naked_sub;
-}
-
-bool subgrid_heuristics(colors_t *subgrid[], size_t size) {
-  bool res = false;
-  res |= cross_hatching(subgrid, size);
-  res |= lone_number(subgrid, size);
-  // res |= naked_subset(subgrid, size);
-  return res;
-}
+  return colors_is_empty(colors_subtract(colors_full(size), summary.colors));
+}
+
+void subgrid_heuristics_select(const unsigned heuristics,
+                               const size_t max_subset) {
+  selected_heuristics = heuristics;
+  subset_max = max_subset;
+}
+
+unsigned subgrid_heuristics_selected(void) { return selected_heuristics; }
+
+/* the subgrid heuristics of each width of candidate sets, which define the
+ * locked sets search of the width. the 32-bit sets are only used by the 25x25
+ * grids, their search comes with the 25-cell units below. */
+#define SUBGRID_LOCKED_SETS
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+
+#define COLORS_T colors128_t
+#define COLORS(op) colors128_##op
+#define SUBGRID(name) colors128_subgrid_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+
+#define COLORS_T colors256_t
+#define COLORS(op) colors256_##op
+#define SUBGRID(name) colors256_subgrid_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+
+#undef SUBGRID_LOCKED_SETS
+
+/* and their specializations for the unit sizes up to 64x64 */
+#define SUBGRID_SIZE 4
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid4_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 9
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid9_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 16
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid16_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 25
+#define SUBGRID_LOCKED_SETS
+#define COLORS_T colors32_t
+#define COLORS(op) colors32_##op
+#define SUBGRID(name) colors32_subgrid25_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_LOCKED_SETS
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 36
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid36_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 49
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid49_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
+
+#define SUBGRID_SIZE 64
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid64_##name
+#include "subgrid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef SUBGRID_SIZE
@@ -0,0 +1,263 @@
+#include "dlx.h"
+#include "colors.h"
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <err.h>
+
+/* search nodes allowed per cell of the grid by dlx_solve(). Algorithm X has
+ * no propagation but the choice of the smallest column, it thrashes on some
+ * sparse grids from 25x25 on: the search is then handed to grid_solve(). */
+#define DLX_NODES_PER_CELL 256
+
+/* Exact cover matrix of a grid of size n, with 4 * n * n columns:
+ *  - cell (r, c) holds a color:    r * n + c
+ *  - row r holds color k:          n * n + r * n + k
+ *  - column c holds color k:   2 * n * n + c * n + k
+ *  - block b holds color k:    3 * n * n + b * n + k
+ * and one matrix row per candidate color k of a cell (r, c), covering these
+ * 4 columns. Node 0 is the root, nodes 1..nb_columns are the column headers
+ * and the nodes of the matrix rows follow, 4 per row. */
+typedef struct {
+  size_t size;
+  size_t nb_columns;
+  int32_t *left;
+  int32_t *right;
+  int32_t *up;
+  int32_t *down;
+  /* column header of each node */
+  int32_t *column;
+  /* number of nodes left in each column */
+  int32_t *column_size;
+  /* candidate (cell * size + color) of the matrix row of each node */
+  int32_t *candidate;
+  size_t nb_nodes;
+  /* candidates of the partial solution */
+  int32_t *solution;
+  size_t depth;
+  size_t nb_solutions;
+  size_t limit;
+  /* search nodes left before giving up (no limit if 0), and if it did */
+  size_t budget;
+  bool given_up;
+} dlx_t;
+
+static void dlx_add_node(dlx_t *dlx, const int32_t node, const int32_t column,
+                         const int32_t candidate) {
+  dlx->column[node] = column;
+  dlx->candidate[node] = candidate;
+  dlx->up[node] = dlx->up[column];
+  dlx->down[node] = column;
+  dlx->down[dlx->up[column]] = node;
+  dlx->up[column] = node;
+  dlx->column_size[column]++;
+}
+
+/* build the matrix from the candidates of the grid cells */
+static void dlx_init(dlx_t *dlx, const grid_t *grid) {
+  size_t size = grid_get_size(grid);
+  size_t nb_cells = size * size;
+  size_t block_size = 1;
+  while (block_size * block_size < size) {
+    block_size++;
+  }
+
+  size_t nb_rows = 0;
+  for (size_t cell = 0; cell < nb_cells; cell++) {
+    for (size_t k = 0; k < size; k++) {
+      nb_rows += grid_has_color(grid, cell / size, cell % size, k);
+    }
+  }
+
+  dlx->size = size;
+  dlx->nb_columns = 4 * nb_cells;
+  size_t capacity = 1 + dlx->nb_columns + 4 * nb_rows;
+  dlx->left = malloc(capacity * sizeof(int32_t));
+  dlx->right = malloc(capacity * sizeof(int32_t));
+  dlx->up = malloc(capacity * sizeof(int32_t));
+  dlx->down = malloc(capacity * sizeof(int32_t));
+  dlx->column = malloc(capacity * sizeof(int32_t));
+  dlx->candidate = malloc(capacity * sizeof(int32_t));
+  dlx->column_size = calloc(capacity, sizeof(int32_t));
+  dlx->solution = malloc((nb_cells + 1) * sizeof(int32_t));
+  if (dlx->left == NULL || dlx->right == NULL || dlx->up == NULL ||
+      dlx->down == NULL || dlx->column == NULL || dlx->candidate == NULL ||
+      dlx->column_size == NULL || dlx->solution == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the exact cover matrix.");
+  }
+  dlx->depth = 0;
+  dlx->nb_solutions = 0;
+  dlx->budget = 0;
+  dlx->given_up = false;
+
+  /* circular list of the column headers, starting at the root */
+  for (size_t i = 0; i <= dlx->nb_columns; i++) {
+    dlx->left[i] = (i == 0) ? dlx->nb_columns : i - 1;
+    dlx->right[i] = (i == dlx->nb_columns) ? 0 : i + 1;
+    dlx->up[i] = i;
+    dlx->down[i] = i;
+    dlx->column[i] = i;
+  }
+
+  int32_t node = dlx->nb_columns + 1;
+  for (size_t cell = 0; cell < nb_cells; cell++) {
+    size_t row = cell / size;
+    size_t col = cell % size;
+    size_t block = (row / block_size) * block_size + col / block_size;
+    for (size_t k = 0; k < size; k++) {
+      if (!grid_has_color(grid, row, col, k)) {
+        continue;
+      }
+
+      int32_t columns[4] = {1 + cell, 1 + nb_cells + row * size + k,
+                            1 + 2 * nb_cells + col * size + k,
+                            1 + 3 * nb_cells + block * size + k};
+      int32_t candidate = cell * size + k;
+      for (size_t i = 0; i < 4; i++) {
+        dlx_add_node(dlx, node + i, columns[i], candidate);
+        dlx->left[node + i] = node + (i + 3) % 4;
+        dlx->right[node + i] = node + (i + 1) % 4;
+      }
+      node += 4;
+    }
+  }
+  dlx->nb_nodes = node;
+}
+
+static void dlx_free(dlx_t *dlx) {
+  free(dlx->left);
+  free(dlx->right);
+  free(dlx->up);
+  free(dlx->down);
+  free(dlx->column);
+  free(dlx->candidate);
+  free(dlx->column_size);
+  free(dlx->solution);
+}
+
+/* remove a column from the header list and its rows from the other columns */
+static void dlx_cover(dlx_t *dlx, const int32_t column) {
+  dlx->right[dlx->left[column]] = dlx->right[column];
+  dlx->left[dlx->right[column]] = dlx->left[column];
+  for (int32_t i = dlx->down[column]; i != column; i = dlx->down[i]) {
+    for (int32_t j = dlx->right[i]; j != i; j = dlx->right[j]) {
+      dlx->down[dlx->up[j]] = dlx->down[j];
+      dlx->up[dlx->down[j]] = dlx->up[j];
+      dlx->column_size[dlx->column[j]]--;
+    }
+  }
+}
+
+/* undo dlx_cover(), in the reverse order */
+static void dlx_uncover(dlx_t *dlx, const int32_t column) {
+  for (int32_t i = dlx->up[column]; i != column; i = dlx->up[i]) {
+    for (int32_t j = dlx->left[i]; j != i; j = dlx->left[j]) {
+      dlx->column_size[dlx->column[j]]++;
+      dlx->down[dlx->up[j]] = j;
+      dlx->up[dlx->down[j]] = j;
+    }
+  }
+  dlx->right[dlx->left[column]] = column;
+  dlx->left[dlx->right[column]] = column;
+}
+
+/* Algorithm X, branching on the column with the fewest rows. returns true
+ * when the search can stop: the solution of the first solution found is left
+ * in dlx->solution. */
+static bool dlx_search(dlx_t *dlx) {
+  if (dlx->budget != 0 && --dlx->budget == 0) {
+    dlx->given_up = true;
+    return true;
+  }
+  if (dlx->right[0] == 0) {
+    dlx->nb_solutions++;
+    return dlx->limit != 0 && dlx->nb_solutions >= dlx->limit;
+  }
+
+  int32_t best = dlx->right[0];
+  for (int32_t c = dlx->right[best]; c != 0; c = dlx->right[c]) {
+    if (dlx->column_size[c] < dlx->column_size[best]) {
+      best = c;
+      if (dlx->column_size[best] <= 1) {
+        break;
+      }
+    }
+  }
+  if (dlx->column_size[best] == 0) {
+    return false;
+  }
+
+  dlx_cover(dlx, best);
+  for (int32_t r = dlx->down[best]; r != best; r = dlx->down[r]) {
+    if (dlx->nb_solutions == 0) {
+      dlx->solution[dlx->depth] = dlx->candidate[r];
+    }
+    dlx->depth++;
+    for (int32_t j = dlx->right[r]; j != r; j = dlx->right[j]) {
+      dlx_cover(dlx, dlx->column[j]);
+    }
+
+    bool stop = dlx_search(dlx);
+
+    for (int32_t j = dlx->left[r]; j != r; j = dlx->left[j]) {
+      dlx_uncover(dlx, dlx->column[j]);
+    }
+    dlx->depth--;
+    if (stop) {
+      dlx_uncover(dlx, best);
+      return true;
+    }
+  }
+  dlx_uncover(dlx, best);
+  return false;
+}
+
+size_t dlx_solve(grid_t *grid) {
+  if (grid == NULL) {
+    return 2;
+  }
+
+  /* the matrix only holds the candidates left by the heuristics */
+  size_t status = grid_heuristics(grid);
+  if (status != 1) {
+    return status;
+  }
+
+  dlx_t dlx;
+  dlx_init(&dlx, grid);
+  dlx.limit = 1;
+  dlx.budget = DLX_NODES_PER_CELL * dlx.size * dlx.size;
+  dlx_search(&dlx);
+
+  status = 2;
+  if (dlx.given_up) {
+    status = grid_solve(grid);
+  } else if (dlx.nb_solutions > 0) {
+    size_t size = dlx.size;
+    for (size_t i = 0; i < size * size; i++) {
+      size_t cell = dlx.solution[i] / size;
+      size_t color_id = dlx.solution[i] % size;
+      grid_set_cell(grid, cell / size, cell % size, color_table[color_id]);
+    }
+    status = 0;
+  }
+  dlx_free(&dlx);
+  return status;
+}
+
+size_t dlx_count_solutions(const grid_t *grid, const size_t limit) {
+  if (grid == NULL) {
+    return 0;
+  }
+
+  dlx_t dlx;
+  dlx_init(&dlx, grid);
+  dlx.limit = limit;
+  dlx_search(&dlx);
+  dlx_free(&dlx);
+  return dlx.nb_solutions;
+}
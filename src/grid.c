@@ -1,45 +1,289 @@
 #include "grid.h"
 #include "colors.h"
+#include "colors_narrow.h"
+#include "colors_wide.h"
+#include "units.h"
 
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <err.h>
-#include <math.h>
 #include <string.h>
 
+#define CACHE_LINE_SIZE 64
+
+/* largest fish looked for: 2 lines (x-wing), 3 (swordfish), 4 (jellyfish) */
+#define FISH_MAX 4
+
+/* operations depending on the width of the candidate sets of a grid, see
+ * grid_template.h */
+typedef struct {
+  /* grid size of a kernel specialized for a single size, 0 otherwise */
+  size_t size;
+  /* bytes and bits of a candidate set */
+  size_t colors_size;
+  size_t max_colors;
+  void (*rollback)(grid_t *grid, const size_t checkpoint);
+  char *(*get_cell)(const grid_t *grid, const size_t cell_id);
+  bool (*has_color)(const grid_t *grid, const size_t cell_id,
+                    const size_t color_id);
+  void (*set_color)(grid_t *grid, const size_t cell_id, const size_t color_id);
+  colors_t (*get_colors)(const grid_t *grid, const size_t cell_id);
+  void (*set_colors)(grid_t *grid, const size_t cell_id, const colors_t colors);
+  bool (*is_consistent)(const grid_t *grid);
+  size_t (*heuristics)(grid_t *grid);
+  size_t (*solve)(grid_t *grid, const grid_search_t *search);
+} grid_kernel_t;
+
 /* Internal structure (hiden from outside) to represent a sudoku grid */
 struct _grid_t {
   size_t size;
-  colors_t **cells;
+  /* operations of the width of candidate sets used by the grid */
+  const grid_kernel_t *kernel;
+  /* size * size cells stored row by row in a single cache-aligned block, the
+   * candidate sets are the narrowest ones holding size colors */
+  void *cells;
+  /* rows, columns and blocks of the grid size */
+  const units_t *units;
+  /* colors placed as singletons in each unit, and how many cells of the unit
+   * hold each of them */
+  void *placed;
+  uint8_t *placed_counts;
+  /* number of (unit, color) placed more than once */
+  size_t conflicts;
+  /* number of cells which are not singletons, and of cells without colors */
+  size_t unsolved;
+  size_t empty;
+  /* undo log: index and previous colors of the cells modified since the
+   * checkpoints still in use */
+  size_t *trail_cells;
+  void *trail_colors;
+  size_t trail_length;
+  size_t trail_capacity;
+  /* epoch at which each cell has been logged last, a cell is logged only once
+   * between two checkpoints */
+  size_t *cell_epochs;
+  size_t epoch;
+  /* cells bucketed by number of candidates, one doubly linked list per count
+   * from 0 to size, kept up to date by write_cell() */
+  cell_id_t *bucket_heads;
+  cell_id_t *bucket_next;
+  cell_id_t *bucket_prev;
+  /* positions[unit * size + color] holds the positions in the unit of the
+   * cells where the color is still a candidate, and dirty[unit] the colors
+   * whose positions changed since the unit was last looked at. both are kept
+   * up to date by write_cell(). */
+  void *positions;
+  void *dirty;
 };
 
+/* end of a bucket list */
+#define NO_CELL ((cell_id_t)-1)
+
+static void bucket_remove(grid_t *grid, const size_t cell_id,
+                          const size_t count) {
+  cell_id_t next = grid->bucket_next[cell_id];
+  cell_id_t prev = grid->bucket_prev[cell_id];
+  if (prev == NO_CELL) {
+    grid->bucket_heads[count] = next;
+  } else {
+    grid->bucket_next[prev] = next;
+  }
+  if (next != NO_CELL) {
+    grid->bucket_prev[next] = prev;
+  }
+}
+
+static void bucket_insert(grid_t *grid, const size_t cell_id,
+                          const size_t count) {
+  cell_id_t head = grid->bucket_heads[count];
+  grid->bucket_next[cell_id] = head;
+  grid->bucket_prev[cell_id] = NO_CELL;
+  if (head != NO_CELL) {
+    grid->bucket_prev[head] = cell_id;
+  }
+  grid->bucket_heads[count] = cell_id;
+}
+
+/* queue of the units waiting for the heuristics, a unit is queued at most
+ * once */
+typedef struct {
+  size_t *unit_ids;
+  bool *queued;
+  size_t capacity;
+  size_t head;
+  size_t length;
+} unit_queue_t;
+
+static void unit_queue_push(unit_queue_t *queue, const size_t unit_id) {
+  if (queue->queued[unit_id]) {
+    return;
+  }
+  queue->queued[unit_id] = true;
+  queue->unit_ids[(queue->head + queue->length) % queue->capacity] = unit_id;
+  queue->length++;
+}
+
+static size_t unit_queue_pop(unit_queue_t *queue) {
+  size_t unit_id = queue->unit_ids[queue->head];
+  queue->head = (queue->head + 1) % queue->capacity;
+  queue->length--;
+  queue->queued[unit_id] = false;
+  return unit_id;
+}
+
+static void unit_queue_clear(unit_queue_t *queue) {
+  while (queue->length > 0) {
+    unit_queue_pop(queue);
+  }
+}
+
+/* a fish being looked for: its color and its lines (rows, or columns if
+ * transposed) */
+typedef struct {
+  grid_t *grid;
+  size_t color_id;
+  bool transposed;
+  unit_queue_t *queue;
+} fish_t;
+
+/* the kernels of each width of candidate sets. the 32- and 64-bit sets only
+ * hold the sizes from 25x25 to 64x64, which all have their own kernel. */
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid_##name
+#define KERNEL(name) grid16_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+
+#define COLORS_T colors128_t
+#define COLORS(op) colors128_##op
+#define SUBGRID(name) colors128_subgrid_##name
+#define KERNEL(name) grid128_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+
+#define COLORS_T colors256_t
+#define COLORS(op) colors256_##op
+#define SUBGRID(name) colors256_subgrid_##name
+#define KERNEL(name) grid256_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+
+/* and the kernels specialized for the sizes up to 64x64 */
+#define KERNEL_SIZE 4
+#define KERNEL_BLOCK_SIZE 2
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid4_##name
+#define KERNEL(name) grid4x4_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 9
+#define KERNEL_BLOCK_SIZE 3
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid9_##name
+#define KERNEL(name) grid9x9_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 16
+#define KERNEL_BLOCK_SIZE 4
+#define COLORS_T colors16_t
+#define COLORS(op) colors16_##op
+#define SUBGRID(name) colors16_subgrid16_##name
+#define KERNEL(name) grid16x16_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 25
+#define KERNEL_BLOCK_SIZE 5
+#define COLORS_T colors32_t
+#define COLORS(op) colors32_##op
+#define SUBGRID(name) colors32_subgrid25_##name
+#define KERNEL(name) grid25x25_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 36
+#define KERNEL_BLOCK_SIZE 6
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid36_##name
+#define KERNEL(name) grid36x36_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 49
+#define KERNEL_BLOCK_SIZE 7
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid49_##name
+#define KERNEL(name) grid49x49_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
+#define KERNEL_SIZE 64
+#define KERNEL_BLOCK_SIZE 8
+#define COLORS_T colors_t
+#define COLORS(op) colors_##op
+#define SUBGRID(name) subgrid64_##name
+#define KERNEL(name) grid64x64_##name
+#include "grid_template.h"
+#undef COLORS_T
+#undef COLORS
+#undef SUBGRID
+#undef KERNEL
+#undef KERNEL_SIZE
+#undef KERNEL_BLOCK_SIZE
+
 bool grid_check_char(const grid_t *grid, const char c) {
-  size_t size = grid->size;
-  switch (size) {
-  case 1:
-    return (c == '_' || c == '1');
-  case 4:
-    return (c == '_' || (c >= '1' && c <= '4'));
-  case 9:
-    return (c == '_' || (c >= '1' && c <= '9'));
-  case 16:
-    return (c == '_' || (c >= '1' && c <= '9') || (c >= 'A' && c <= 'G'));
-  case 25:
-    return (c == '_' || (c >= '1' && c <= '9') || (c >= 'A' && c <= 'P'));
-  case 36:
-    return (c == '_' || (c >= '1' && c <= '9') || (c >= 'A' && c <= 'Z') ||
-            c == '@');
-  case 49:
-    return (c == '_' || (c >= '1' && c <= '9') || (c >= 'A' && c <= 'Z') ||
-            c == '@' || (c >= 'a' && c <= 'm'));
-  case 64:
-    return (c == '_' || (c >= '1' && c <= '9') || (c >= 'A' && c <= 'Z') ||
-            c == '@' || (c >= 'a' && c <= 'z') || c == '&' || c == '*');
-  default:
-    errx(EXIT_FAILURE, "wrong size for the grid !");
+  if (c == EMPTY_CELL) {
+    return true;
   }
+  return c != '\0' && memchr(color_table, c, grid->size) != NULL;
 }
 
 grid_t *grid_alloc(size_t size) {
@@ -47,21 +291,82 @@ grid_t *grid_alloc(size_t size) {
     return NULL;
   }
 
-  colors_t **cells = calloc(size, sizeof(colors_t *));
-  if (cells == NULL) {
-    errx(EXIT_FAILURE, "can't allocate memory for the grid !");
+  /* the kernel specialized for the grid size, otherwise the one of the
+   * narrowest candidate sets holding the colors of the grid */
+  static const grid_kernel_t *const kernels[] = {
+      &grid4x4_kernel,   &grid9x9_kernel,   &grid16x16_kernel,
+      &grid25x25_kernel, &grid36x36_kernel, &grid49x49_kernel,
+      &grid64x64_kernel, &grid16_kernel,    &grid128_kernel,
+      &grid256_kernel};
+  size_t nb_kernels = sizeof(kernels) / sizeof(kernels[0]);
+  const grid_kernel_t *kernel = NULL;
+  for (size_t i = 0; i < nb_kernels && kernel == NULL; i++) {
+    if (kernels[i]->size == size ||
+        (kernels[i]->size == 0 && size <= kernels[i]->max_colors)) {
+      kernel = kernels[i];
+    }
   }
 
-  for (size_t i = 0; i < size; i++) {
-    cells[i] = calloc(size, sizeof(colors_t));
-    if (cells[i] == NULL) {
-      errx(EXIT_FAILURE, "can't allocate cells[i] in grid_alloc.");
-    }
+  /* aligned_alloc() needs a size multiple of the alignment */
+  size_t cells_size = size * size * kernel->colors_size;
+  cells_size = (cells_size + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+  void *cells = aligned_alloc(CACHE_LINE_SIZE, cells_size);
+  if (cells == NULL) {
+    errx(EXIT_FAILURE, "can't allocate memory for the grid !");
   }
+  memset(cells, 0, cells_size);
 
   grid_t *grid = malloc(sizeof(grid_t));
+  if (grid == NULL) {
+    errx(EXIT_FAILURE, "can't allocate memory for the grid !");
+  }
   grid->size = size;
+  grid->kernel = kernel;
   grid->cells = cells;
+  grid->units = units_get(size);
+
+  size_t nb_units = grid->units->nb_units;
+  grid->placed = calloc(nb_units, kernel->colors_size);
+  grid->placed_counts = calloc(nb_units * size, sizeof(uint8_t));
+  if (grid->placed == NULL || grid->placed_counts == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the unit masks in grid_alloc.");
+  }
+  /* the cells start without candidates, so do the positions */
+  grid->positions = calloc(nb_units * size, kernel->colors_size);
+  grid->dirty = calloc(nb_units, kernel->colors_size);
+  if (grid->positions == NULL || grid->dirty == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the unit positions in grid_alloc.");
+  }
+  grid->conflicts = 0;
+  grid->unsolved = size * size;
+  grid->empty = size * size;
+
+  grid->trail_capacity = size * size;
+  grid->trail_length = 0;
+  grid->trail_cells = malloc(grid->trail_capacity * sizeof(size_t));
+  grid->trail_colors = malloc(grid->trail_capacity * kernel->colors_size);
+  grid->cell_epochs = calloc(size * size, sizeof(size_t));
+  if (grid->trail_cells == NULL || grid->trail_colors == NULL ||
+      grid->cell_epochs == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the undo log in grid_alloc.");
+  }
+  grid->epoch = 0;
+
+  /* the cells start without candidates, all in the bucket 0 */
+  size_t nb_cells = size * size;
+  grid->bucket_heads = malloc((size + 1) * sizeof(cell_id_t));
+  grid->bucket_next = malloc(nb_cells * sizeof(cell_id_t));
+  grid->bucket_prev = malloc(nb_cells * sizeof(cell_id_t));
+  if (grid->bucket_heads == NULL || grid->bucket_next == NULL ||
+      grid->bucket_prev == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the cell buckets in grid_alloc.");
+  }
+  for (size_t count = 0; count <= size; count++) {
+    grid->bucket_heads[count] = NO_CELL;
+  }
+  for (size_t cell_id = nb_cells; cell_id-- > 0;) {
+    bucket_insert(grid, cell_id, 0);
+  }
   grid_t *grid_ptr = grid;
   return grid_ptr;
 }
@@ -71,15 +376,38 @@ void grid_free(grid_t *grid) {
     return;
   }
 
-  size_t size = grid->size;
-  colors_t **cells = grid->cells;
-  for (size_t i = 0; i < size; i++) {
-    free(cells[i]);
-  }
-  free(cells);
+  free(grid->cells);
+  free(grid->placed);
+  free(grid->placed_counts);
+  free(grid->positions);
+  free(grid->dirty);
+  free(grid->trail_cells);
+  free(grid->trail_colors);
+  free(grid->cell_epochs);
+  free(grid->bucket_heads);
+  free(grid->bucket_next);
+  free(grid->bucket_prev);
   free(grid);
 }
 
+size_t grid_checkpoint(grid_t *grid) {
+  if (grid == NULL) {
+    return 0;
+  }
+  grid->epoch++;
+  return grid->trail_length;
+}
+
+void grid_rollback(grid_t *grid, const size_t checkpoint) {
+  if (grid == NULL || checkpoint > grid->trail_length) {
+    return;
+  }
+
+  grid->kernel->rollback(grid, checkpoint);
+  /* cells logged before the rollback must be logged again */
+  grid->epoch++;
+}
+
 void grid_print(grid_t *grid, FILE *fd) {
   if (grid == NULL) {
     return;
@@ -109,6 +437,10 @@ bool grid_check_size(const size_t size) {
   case 36:
   case 49:
   case 64:
+  case 81:
+  case 100:
+  case 121:
+  case 144:
     valid_size = true;
     break;
   }
@@ -121,12 +453,24 @@ grid_t *grid_copy(const grid_t *grid) {
   }
 
   size_t size = grid->size;
+  size_t colors_size = grid->kernel->colors_size;
   grid_t *new_grid = grid_alloc(size);
-  for (size_t i = 0; i < size; i++) {
-    for (size_t j = 0; j < size; j++) {
-      new_grid->cells[i][j] = grid->cells[i][j];
-    }
-  }
+  size_t nb_units = grid->units->nb_units;
+  memcpy(new_grid->cells, grid->cells, size * size * colors_size);
+  memcpy(new_grid->placed, grid->placed, nb_units * colors_size);
+  memcpy(new_grid->placed_counts, grid->placed_counts,
+         nb_units * size * sizeof(uint8_t));
+  memcpy(new_grid->positions, grid->positions, nb_units * size * colors_size);
+  memcpy(new_grid->dirty, grid->dirty, nb_units * colors_size);
+  memcpy(new_grid->bucket_heads, grid->bucket_heads,
+         (size + 1) * sizeof(cell_id_t));
+  memcpy(new_grid->bucket_next, grid->bucket_next,
+         size * size * sizeof(cell_id_t));
+  memcpy(new_grid->bucket_prev, grid->bucket_prev,
+         size * size * sizeof(cell_id_t));
+  new_grid->conflicts = grid->conflicts;
+  new_grid->unsolved = grid->unsolved;
+  new_grid->empty = grid->empty;
   return new_grid;
 }
 
@@ -139,18 +483,7 @@ char *grid_get_cell(const grid_t *grid, const size_t row, const size_t column) {
   if (row > size || column > size) {
     return NULL;
   }
-
-  int string_index = 0;
-  colors_t color_cell = grid->cells[row][column];
-  char *color_string = malloc(colors_count(color_cell) + 1 * sizeof(char));
-  for (size_t color_id = 0; color_id < MAX_COLORS; color_id++) {
-    if (colors_is_in(color_cell, color_id)) {
-      color_string[string_index] = color_table[color_id];
-      string_index++;
-    }
-  }
-  color_string[string_index] = '\0';
-  return color_string;
+  return grid->kernel->get_cell(grid, row * size + column);
 }
 
 size_t grid_get_size(const grid_t *grid) {
@@ -172,145 +505,65 @@ void grid_set_cell(grid_t *grid, const size_t row, const size_t column,
   }
 
   if (color == EMPTY_CELL) {
-    grid->cells[row][column] = colors_full(size);
+    grid->kernel->set_color(grid, row * size + column, size);
     return;
   }
 
-  char *index = strchr(color_table, color);
+  char *index = memchr(color_table, color, size);
   size_t color_id = (index - color_table) / sizeof(char);
-  grid->cells[row][column] = colors_set(color_id);
+  grid->kernel->set_color(grid, row * size + column, color_id);
 }
 
-bool grid_is_solved(grid_t *grid) {
-  if (grid == NULL) {
-    return false;
+colors_t grid_get_colors(const grid_t *grid, const size_t row,
+                         const size_t column) {
+  if (grid == NULL || row >= grid->size || column >= grid->size) {
+    return colors_empty();
   }
+  return grid->kernel->get_colors(grid, row * grid->size + column);
+}
 
-  size_t size = grid->size;
-  for (size_t row = 0; row < size; row++) {
-    for (size_t column = 0; column < size; column++) {
-      colors_t grid_char = grid->cells[row][column];
-      if (!colors_is_singleton(grid_char) || grid_char == '_') {
-        return false;
-      }
-    }
+void grid_set_colors(grid_t *grid, const size_t row, const size_t column,
+                     const colors_t colors) {
+  if (grid == NULL || row >= grid->size || column >= grid->size) {
+    return;
   }
-  return true;
+  grid->kernel->set_colors(grid, row * grid->size + column, colors);
 }
 
-bool grid_is_consistent(grid_t *grid) {
-  size_t size = grid->size;
-  colors_t subgrid[size];
-  size_t cell_id = 0;
-  for (size_t i = 0; i < size; i++) {
-    for (size_t j = 0; j < size; j++) {
-      subgrid[cell_id] = grid->cells[i][j];
-      cell_id++;
-    }
-
-    if (!subgrid_consistency(subgrid, size)) {
-      return false;
-    }
-    cell_id = 0;
+bool grid_has_color(const grid_t *grid, const size_t row, const size_t column,
+                    const size_t color_id) {
+  if (grid == NULL || row >= grid->size || column >= grid->size) {
+    return false;
   }
-  for (size_t j = 0; j < size; j++) {
-    for (size_t i = 0; i < size; i++) {
-      subgrid[cell_id] = grid->cells[i][j];
-      cell_id++;
-    }
+  return grid->kernel->has_color(grid, row * grid->size + column, color_id);
+}
 
-    if (!subgrid_consistency(subgrid, size)) {
-      return false;
-    }
-    cell_id = 0;
-  }
-
-  double block_size = sqrt((double)grid->size);
-  for (size_t i = 0; i < grid->size; i += block_size) {
-    for (size_t j = 0; j < grid->size; j += block_size) {
-      for (size_t k = i; k < i + block_size; k++) {
-        for (size_t l = j; l < j + block_size; l++) {
-          subgrid[cell_id] = grid->cells[k][l];
-          cell_id++;
-        }
-      }
-
-      if (!subgrid_consistency(subgrid, size)) {
-        return false;
-      }
-      cell_id = 0;
-    }
+bool grid_is_solved(grid_t *grid) {
+  if (grid == NULL) {
+    return false;
   }
-
-  // BLOCK PART
-  /*size_t block_size = (size_t) sqrt(grid->size); // make a func ?
-  for(size_t block_id = 0; block_id < grid->size; block_id++)
-  {
-      size_t row_offset = (block_id / block_size) * block_size;
-      size_t column_offset = (block_id % block_size ) * block_size;
-      for(size_t i = 0; i < block_size; i ++)
-      {
-          for(size_t j = 0; j < block_size; j ++)
-          {
-              //printf("\t(%ld,%ld) = '%s', (%ld)", i, j,
-  grid_get_cell(grid,k,l), colors_count(grid->cells[k][l])); subgrid[cell_id++]
-  = grid->cells[j + row_offset][j + column_offset];
-          }
-          cell_id = 0;
-          if(!subgrid_consistency(subgrid,size))
-          {
-              printf("block %ld inconsistent",block_id);
-              return false;
-          }
-      }
-  }*/
-  return true;
+  return grid->unsolved == 0;
 }
 
-size_t grid_heuristics(grid_t *grid) {
-  size_t size = grid->size;
-  colors_t *subgrid[size];
-  size_t cell_id = 0;
-  bool has_changed = true;
-  while (has_changed) {
-    has_changed = false;
-    for (size_t i = 0; i < size; i++) {
-      for (size_t j = 0; j < size; j++) {
-        subgrid[cell_id] = &(grid->cells[i][j]);
-        cell_id++;
-      }
-      has_changed |= subgrid_heuristics(subgrid, size);
-      cell_id = 0;
-    }
+bool grid_is_consistent(grid_t *grid) {
+  if (grid->empty > 0 || grid->conflicts > 0) {
+    return false;
+  }
+  return grid->kernel->is_consistent(grid);
+}
 
-    for (size_t j = 0; j < size; j++) {
-      for (size_t i = 0; i < size; i++) {
-        subgrid[cell_id] = &(grid->cells[i][j]);
-        cell_id++;
-      }
-      has_changed |= subgrid_heuristics(subgrid, size);
-      cell_id = 0;
-    }
+size_t grid_heuristics(grid_t *grid) { return grid->kernel->heuristics(grid); }
 
-    double block_size = sqrt((double)grid->size);
-    for (size_t i = 0; i < grid->size; i += block_size) {
-      for (size_t j = 0; j < grid->size; j += block_size) {
-        for (size_t k = i; k < i + block_size; k++) {
-          for (size_t l = j; l < j + block_size; l++) {
-            subgrid[cell_id] = &(grid->cells[k][l]);
-            cell_id++;
-          }
-        }
-        has_changed |= subgrid_heuristics(subgrid, size);
-        cell_id = 0;
-      }
-    }
+size_t grid_solve(grid_t *grid) {
+  if (grid == NULL) {
+    return 2;
   }
-  if (grid_is_consistent(grid)) {
-    if (grid_is_solved(grid)) {
-      return 0;
-    }
-    return 1;
+  return grid->kernel->solve(grid, NULL);
+}
+
+size_t grid_search(grid_t *grid, const grid_search_t *search) {
+  if (grid == NULL) {
+    return 2;
   }
-  return 2;
+  return grid->kernel->solve(grid, search);
 }
@@ -0,0 +1,587 @@
+/* Grid operations depending on the width of the candidate sets, written once
+ * for every width. The file including it defines:
+ *  - COLORS_T: the type of the sets stored in the cells,
+ *  - COLORS(op): the name of the operation op on these sets,
+ *  - SUBGRID(name): the name of the subgrid function name for these sets,
+ *  - KERNEL(name): the name given to the function name of this width.
+ * It may also define KERNEL_SIZE and KERNEL_BLOCK_SIZE to specialize the
+ * kernel for a single grid size: the sizes are then compile-time constants,
+ * so the unit loops can be unrolled and the unit arrays have a fixed size.
+ * The functions are gathered in the grid_kernel_t table KERNEL(kernel). There
+ * is no include guard, it is included once per width and size by grid.c. */
+
+#ifdef KERNEL_SIZE
+#define KERNEL_GRID_SIZE(grid) ((size_t)KERNEL_SIZE)
+#define KERNEL_GRID_BLOCK_SIZE(grid) ((size_t)KERNEL_BLOCK_SIZE)
+#else
+#define KERNEL_GRID_SIZE(grid) ((grid)->size)
+#define KERNEL_GRID_BLOCK_SIZE(grid) ((grid)->units->block_size)
+#endif
+
+/* add (or remove) a singleton color to the placed colors of the units of a
+ * cell, counting the colors placed twice in a unit */
+static void KERNEL(place_color)(grid_t *grid, const size_t cell_id,
+                                const COLORS_T color, const bool placed) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  COLORS_T *placed_colors = grid->placed;
+  size_t color_id = COLORS(rightmost_id)(color);
+  const cell_id_t *cell_units = units_of_cell(grid->units, cell_id);
+  for (size_t k = 0; k < 3; k++) {
+    size_t unit_id = cell_units[k];
+    uint8_t *count = &(grid->placed_counts[unit_id * size + color_id]);
+    if (placed) {
+      if (!COLORS(is_empty)(COLORS(and)(placed_colors[unit_id], color))) {
+        grid->conflicts++;
+      } else {
+        placed_colors[unit_id] = COLORS(or)(placed_colors[unit_id], color);
+      }
+      (*count)++;
+    } else {
+      (*count)--;
+      if (*count > 0) {
+        grid->conflicts--;
+      } else {
+        placed_colors[unit_id] =
+            COLORS(subtract)(placed_colors[unit_id], color);
+      }
+    }
+  }
+}
+
+/* toggle the position of a cell in the positions of the given colors in
+ * each of its units, marking these colors dirty */
+static void KERNEL(toggle_positions)(grid_t *grid, const size_t cell_id,
+                                     const COLORS_T colors) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  COLORS_T *positions = grid->positions;
+  COLORS_T *dirty = grid->dirty;
+  const cell_id_t *cell_units = units_of_cell(grid->units, cell_id);
+  const cell_id_t *cell_positions =
+      units_positions_of_cell(grid->units, cell_id);
+  for (size_t k = 0; k < 3; k++) {
+    size_t unit_id = cell_units[k];
+    COLORS_T position = COLORS(set)(cell_positions[k]);
+    COLORS_T *unit_positions = positions + unit_id * size;
+    COLORS(foreach)(color_id, colors) {
+      unit_positions[color_id] =
+          COLORS(xor)(unit_positions[color_id], position);
+    }
+    dirty[unit_id] = COLORS(or)(dirty[unit_id], colors);
+  }
+}
+
+/* set the colors of a cell, keeping the unit masks, the positions, the
+ * counters and the buckets of the grid up to date */
+static void KERNEL(write_cell)(grid_t *grid, const size_t cell_id,
+                               const COLORS_T colors) {
+  COLORS_T *cells = grid->cells;
+  COLORS_T old_colors = cells[cell_id];
+  KERNEL(toggle_positions)(grid, cell_id, COLORS(xor)(old_colors, colors));
+  size_t old_count = COLORS(count)(old_colors);
+  size_t count = COLORS(count)(colors);
+  if (old_count != count) {
+    bucket_remove(grid, cell_id, old_count);
+    bucket_insert(grid, cell_id, count);
+  }
+  if (COLORS(is_singleton)(old_colors)) {
+    KERNEL(place_color)(grid, cell_id, old_colors, false);
+    grid->unsolved++;
+  } else if (COLORS(is_empty)(old_colors)) {
+    grid->empty--;
+  }
+
+  if (COLORS(is_singleton)(colors)) {
+    KERNEL(place_color)(grid, cell_id, colors, true);
+    grid->unsolved--;
+  } else if (COLORS(is_empty)(colors)) {
+    grid->empty++;
+  }
+  cells[cell_id] = colors;
+}
+
+/* change the colors of a cell, logging its previous colors if it has not been
+ * logged since the last checkpoint */
+static void KERNEL(update_cell)(grid_t *grid, const size_t cell_id,
+                                const COLORS_T colors) {
+  COLORS_T *cell = &(((COLORS_T *)grid->cells)[cell_id]);
+  if (COLORS(is_equal)(*cell, colors)) {
+    return;
+  }
+
+  if (grid->cell_epochs[cell_id] != grid->epoch) {
+    if (grid->trail_length == grid->trail_capacity) {
+      grid->trail_capacity *= 2;
+      grid->trail_cells = realloc(grid->trail_cells,
+                                  grid->trail_capacity * sizeof(size_t));
+      grid->trail_colors = realloc(grid->trail_colors,
+                                   grid->trail_capacity * sizeof(COLORS_T));
+      if (grid->trail_cells == NULL || grid->trail_colors == NULL) {
+        errx(EXIT_FAILURE, "can't grow the undo log of the grid.");
+      }
+    }
+    grid->trail_cells[grid->trail_length] = cell_id;
+    ((COLORS_T *)grid->trail_colors)[grid->trail_length] = *cell;
+    grid->trail_length++;
+    grid->cell_epochs[cell_id] = grid->epoch;
+  }
+  KERNEL(write_cell)(grid, cell_id, colors);
+}
+
+static void KERNEL(rollback)(grid_t *grid, const size_t checkpoint) {
+  const COLORS_T *trail_colors = grid->trail_colors;
+  while (grid->trail_length > checkpoint) {
+    grid->trail_length--;
+    KERNEL(write_cell)(grid, grid->trail_cells[grid->trail_length],
+                       trail_colors[grid->trail_length]);
+  }
+}
+
+static char *KERNEL(get_cell)(const grid_t *grid, const size_t cell_id) {
+  int string_index = 0;
+  COLORS_T color_cell = ((const COLORS_T *)grid->cells)[cell_id];
+  char *color_string = malloc(COLORS(count)(color_cell) + 1 * sizeof(char));
+  COLORS(foreach)(color_id, color_cell) {
+    color_string[string_index] = color_table[color_id];
+    string_index++;
+  }
+  color_string[string_index] = '\0';
+  return color_string;
+}
+
+static bool KERNEL(has_color)(const grid_t *grid, const size_t cell_id,
+                              const size_t color_id) {
+  return COLORS(is_in)(((const COLORS_T *)grid->cells)[cell_id], color_id);
+}
+
+/* set a cell to a single color, or to all the colors if color_id is out of
+ * the grid size */
+static void KERNEL(set_color)(grid_t *grid, const size_t cell_id,
+                              const size_t color_id) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  if (color_id >= size) {
+    KERNEL(update_cell)(grid, cell_id, COLORS(full)(size));
+  } else {
+    KERNEL(update_cell)(grid, cell_id, COLORS(set)(color_id));
+  }
+}
+
+/* the first MAX_COLORS colors of a cell */
+static colors_t KERNEL(get_colors)(const grid_t *grid, const size_t cell_id) {
+  colors_t colors = colors_empty();
+  COLORS(foreach)(color_id, ((const COLORS_T *)grid->cells)[cell_id]) {
+    if (color_id >= MAX_COLORS) {
+      break;
+    }
+    colors = colors_add(colors, color_id);
+  }
+  return colors;
+}
+
+static void KERNEL(set_colors)(grid_t *grid, const size_t cell_id,
+                               const colors_t colors) {
+  COLORS_T cell = COLORS(empty)();
+  colors_foreach(color_id,
+                 colors_and(colors, colors_full(KERNEL_GRID_SIZE(grid)))) {
+    cell = COLORS(add)(cell, color_id);
+  }
+  KERNEL(update_cell)(grid, cell_id, cell);
+}
+
+/* each color must still fit somewhere in each unit: none of the positions
+ * kept for the units is empty. this scans them all, the propagation only
+ * looks at the dirty colors of the units it is given. */
+static bool KERNEL(is_consistent)(const grid_t *grid) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const COLORS_T *positions = grid->positions;
+  size_t nb_positions = grid->units->nb_units * size;
+  bool consistent = true;
+  for (size_t i = 0; i < nb_positions; i++) {
+    consistent &= !COLORS(is_empty)(positions[i]);
+  }
+  return consistent;
+}
+
+/* the dirty colors of a unit must still fit somewhere in it, the positions
+ * of the other colors haven't changed since the unit was last checked */
+static bool KERNEL(unit_is_consistent)(const grid_t *grid,
+                                       const size_t unit_id) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const COLORS_T *positions =
+      (const COLORS_T *)grid->positions + unit_id * size;
+  COLORS(foreach)(color_id, ((const COLORS_T *)grid->dirty)[unit_id]) {
+    if (COLORS(is_empty)(positions[color_id])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* hidden singles of a unit read from its positions, for the dirty colors
+ * only: a color with a single position is placed there, the units of the
+ * placed cells are queued. returns false if a color has no position left. */
+static bool KERNEL(unit_hidden_singles)(grid_t *grid, const size_t unit_id,
+                                        unit_queue_t *queue) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const units_t *units = grid->units;
+  const COLORS_T *cells = grid->cells;
+  const COLORS_T *positions =
+      (const COLORS_T *)grid->positions + unit_id * size;
+  COLORS_T *dirty = &(((COLORS_T *)grid->dirty)[unit_id]);
+  const cell_id_t *cell_ids = units_cells(units, unit_id);
+  /* placing a color dirties the other colors of its cell in this unit too,
+   * they are looked at in the same loop */
+  while (!COLORS(is_empty)(*dirty)) {
+    size_t color_id = COLORS(rightmost_id)(*dirty);
+    *dirty = COLORS(discard)(*dirty, color_id);
+    COLORS_T color_positions = positions[color_id];
+    if (COLORS(is_empty)(color_positions)) {
+      return false;
+    }
+    if (!COLORS(is_singleton)(color_positions)) {
+      continue;
+    }
+    size_t cell_id = cell_ids[COLORS(rightmost_id)(color_positions)];
+    COLORS_T color = COLORS(set)(color_id);
+    if (!COLORS(is_equal)(cells[cell_id], color)) {
+      KERNEL(update_cell)(grid, cell_id, color);
+      const cell_id_t *cell_units = units_of_cell(units, cell_id);
+      for (size_t k = 0; k < 3; k++) {
+        unit_queue_push(queue, cell_units[k]);
+      }
+    }
+  }
+  return true;
+}
+
+/* run the subgrid heuristics on a unit and write the changes back through
+ * the undo log, queuing the units of the changed cells. the hidden singles
+ * come from the positions of the unit, the other heuristics from its cells.
+ * returns false as soon as a cell or a unit becomes inconsistent. */
+static bool KERNEL(unit_heuristics)(grid_t *grid, const size_t unit_id,
+                                    const unsigned heuristics,
+                                    unit_queue_t *queue) {
+  if (heuristics & HEURISTIC_LONE_NUMBER) {
+    if (!KERNEL(unit_hidden_singles)(grid, unit_id, queue)) {
+      return false;
+    }
+  } else if (!KERNEL(unit_is_consistent)(grid, unit_id)) {
+    return false;
+  }
+  unsigned cell_heuristics =
+      heuristics & (HEURISTIC_CROSS_HATCHING | HEURISTIC_NAKED_SUBSET |
+                    HEURISTIC_HIDDEN_SUBSET);
+  if (cell_heuristics == 0) {
+    return grid->empty == 0 && grid->conflicts == 0;
+  }
+
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const units_t *units = grid->units;
+  const COLORS_T *cells = grid->cells;
+  const cell_id_t *cell_ids = units_cells(units, unit_id);
+  COLORS_T colors[size];
+  COLORS_T *subgrid[size];
+  for (size_t i = 0; i < size; i++) {
+    colors[i] = cells[cell_ids[i]];
+    subgrid[i] = &(colors[i]);
+  }
+
+  if (!SUBGRID(apply)(subgrid, size, cell_heuristics)) {
+    return grid->empty == 0 && grid->conflicts == 0;
+  }
+
+  for (size_t i = 0; i < size; i++) {
+    if (!COLORS(is_equal)(colors[i], cells[cell_ids[i]])) {
+      KERNEL(update_cell)(grid, cell_ids[i], colors[i]);
+      const cell_id_t *cell_units = units_of_cell(units, cell_ids[i]);
+      for (size_t k = 0; k < 3; k++) {
+        unit_queue_push(queue, cell_units[k]);
+      }
+    }
+  }
+  return grid->empty == 0 && grid->conflicts == 0;
+}
+
+/* discard colors from a cell through the undo log, queuing its units if it
+ * changed */
+static void KERNEL(discard_colors)(grid_t *grid, const size_t cell_id,
+                                   const COLORS_T colors,
+                                   unit_queue_t *queue) {
+  COLORS_T cell = ((COLORS_T *)grid->cells)[cell_id];
+  if (COLORS(is_empty)(COLORS(and)(cell, colors))) {
+    return;
+  }
+  KERNEL(update_cell)(grid, cell_id, COLORS(subtract)(cell, colors));
+  const cell_id_t *cell_units = units_of_cell(grid->units, cell_id);
+  for (size_t k = 0; k < 3; k++) {
+    unit_queue_push(queue, cell_units[k]);
+  }
+}
+
+/* box-line intersections of the rows (or of the columns if transposed).
+ * parts[line][block] holds the candidates of a line inside each block it
+ * crosses. a color of an intersection which is nowhere else in the block
+ * can't be on the rest of the line (pointing), and one which is nowhere
+ * else on the line can't be on the rest of the block (claiming). */
+static void KERNEL(line_intersections)(grid_t *grid, const size_t block_size,
+                                       COLORS_T parts[][block_size],
+                                       const bool transposed,
+                                       unit_queue_t *queue) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  for (size_t line = 0; line < size; line++) {
+    size_t band = line - line % block_size;
+    for (size_t part = 0; part < block_size; part++) {
+      COLORS_T line_rest = COLORS(empty)();
+      for (size_t p = 0; p < block_size; p++) {
+        if (p != part) {
+          line_rest = COLORS(or)(line_rest, parts[line][p]);
+        }
+      }
+      COLORS_T block_rest = COLORS(empty)();
+      for (size_t l = band; l < band + block_size; l++) {
+        if (l != line) {
+          block_rest = COLORS(or)(block_rest, parts[l][part]);
+        }
+      }
+
+      COLORS_T pointing = COLORS(subtract)(parts[line][part], block_rest);
+      COLORS_T claiming = COLORS(subtract)(parts[line][part], line_rest);
+      size_t first = part * block_size;
+      if (!COLORS(is_empty)(pointing)) {
+        for (size_t pos = 0; pos < size; pos++) {
+          if (pos < first || pos >= first + block_size) {
+            size_t cell_id =
+                transposed ? pos * size + line : line * size + pos;
+            KERNEL(discard_colors)(grid, cell_id, pointing, queue);
+          }
+        }
+      }
+      if (!COLORS(is_empty)(claiming)) {
+        for (size_t l = band; l < band + block_size; l++) {
+          if (l == line) {
+            continue;
+          }
+          for (size_t pos = first; pos < first + block_size; pos++) {
+            size_t cell_id = transposed ? pos * size + l : l * size + pos;
+            KERNEL(discard_colors)(grid, cell_id, claiming, queue);
+          }
+        }
+      }
+    }
+  }
+}
+
+/* box-line intersections of the whole grid, the units of the changed cells
+ * are queued. the candidates are gathered once: the cells only lose colors
+ * meanwhile, so the deductions made on them stay valid. */
+static void KERNEL(intersections)(grid_t *grid, unit_queue_t *queue) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const size_t block_size = KERNEL_GRID_BLOCK_SIZE(grid);
+  const COLORS_T *cells = grid->cells;
+  COLORS_T row_parts[size][block_size];
+  COLORS_T column_parts[size][block_size];
+  for (size_t i = 0; i < size; i++) {
+    for (size_t b = 0; b < block_size; b++) {
+      row_parts[i][b] = COLORS(empty)();
+      column_parts[i][b] = COLORS(empty)();
+    }
+  }
+  for (size_t i = 0; i < size; i++) {
+    for (size_t j = 0; j < size; j++) {
+      COLORS_T cell = cells[i * size + j];
+      row_parts[i][j / block_size] =
+          COLORS(or)(row_parts[i][j / block_size], cell);
+      column_parts[j][i / block_size] =
+          COLORS(or)(column_parts[j][i / block_size], cell);
+    }
+  }
+  KERNEL(line_intersections)(grid, block_size, row_parts, false, queue);
+  KERNEL(line_intersections)(grid, block_size, column_parts, true, queue);
+}
+
+/* the lines of a fish (members) hold the color in its positions (colors)
+ * only, so the color is removed from these positions on the other lines */
+static bool KERNEL(fish_found)(const COLORS_T members, const COLORS_T colors,
+                               void *data) {
+  fish_t *fish = data;
+  grid_t *grid = fish->grid;
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const COLORS_T *cells = grid->cells;
+  COLORS_T color = COLORS(set)(fish->color_id);
+  bool res = false;
+  COLORS(foreach)(line, COLORS(subtract)(COLORS(full)(size), members)) {
+    COLORS(foreach)(pos, colors) {
+      size_t cell_id = fish->transposed ? pos * size + line : line * size + pos;
+      if (!COLORS(is_empty)(COLORS(and)(cells[cell_id], color))) {
+        KERNEL(discard_colors)(grid, cell_id, color, fish->queue);
+        res = true;
+      }
+    }
+  }
+  return res;
+}
+
+/* fish of each color: n rows whose candidate positions for the color lie in
+ * n columns (or the reverse), found as locked sets of the positions of the
+ * color in the rows and in the columns. the units of the changed cells are
+ * queued. */
+static void KERNEL(fish)(grid_t *grid, unit_queue_t *queue) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  const COLORS_T *positions = grid->positions;
+  /* the rows are the units 0 to size - 1, the columns the next size ones */
+  COLORS_T lines[size];
+  for (size_t color_id = 0; color_id < size; color_id++) {
+    fish_t fish = {grid, color_id, false, queue};
+    for (size_t row = 0; row < size; row++) {
+      lines[row] = positions[row * size + color_id];
+    }
+    COLORS(locked_sets)(lines, size, FISH_MAX, KERNEL(fish_found), &fish);
+    fish.transposed = true;
+    for (size_t column = 0; column < size; column++) {
+      lines[column] = positions[(size + column) * size + color_id];
+    }
+    COLORS(locked_sets)(lines, size, FISH_MAX, KERNEL(fish_found), &fish);
+  }
+}
+
+/* run the heuristics on the queued units until none is left, the units of
+ * the changed cells being queued in turn. the queue is left empty. a color
+ * only loses a position when a cell loses it, which dirties the color in the
+ * units of the cell and queues them: the positions are checked along the way
+ * and the counters are enough at the end. */
+static size_t KERNEL(propagate)(grid_t *grid, unit_queue_t *queue) {
+  unsigned heuristics = subgrid_heuristics_selected();
+  while (queue->length > 0) {
+    if (!KERNEL(unit_heuristics)(grid, unit_queue_pop(queue), heuristics,
+                                 queue)) {
+      unit_queue_clear(queue);
+      return 2;
+    }
+    /* the heuristics crossing the units are only looked for once the units
+     * are settled, the cheapest first */
+    if (queue->length == 0 && (heuristics & HEURISTIC_INTERSECTION)) {
+      KERNEL(intersections)(grid, queue);
+    }
+    if (queue->length == 0 && (heuristics & HEURISTIC_FISH)) {
+      KERNEL(fish)(grid, queue);
+    }
+    if (grid->empty > 0 || grid->conflicts > 0) {
+      unit_queue_clear(queue);
+      return 2;
+    }
+  }
+  if (grid->unsolved == 0) {
+    return 0;
+  }
+  return 1;
+}
+
+/* the heuristics on every unit of the grid, whose positions are checked in
+ * full first: a color may miss from a unit without ever having been dirty */
+static size_t KERNEL(propagate_all)(grid_t *grid, unit_queue_t *queue) {
+  if (grid->empty > 0 || grid->conflicts > 0 ||
+      !KERNEL(is_consistent)(grid)) {
+    return 2;
+  }
+  for (size_t unit_id = 0; unit_id < grid->units->nb_units; unit_id++) {
+    unit_queue_push(queue, unit_id);
+  }
+  return KERNEL(propagate)(grid, queue);
+}
+
+static size_t KERNEL(heuristics)(grid_t *grid) {
+  size_t nb_units = grid->units->nb_units;
+  size_t unit_ids[nb_units];
+  bool queued[nb_units];
+  unit_queue_t queue = {unit_ids, queued, nb_units, 0, 0};
+  memset(queued, 0, sizeof(queued));
+  return KERNEL(propagate_all)(grid, &queue);
+}
+
+/* the unsolved cell with the fewest candidates, the head of the first non
+ * empty bucket from 2 candidates on. returns false if every cell is a
+ * singleton. */
+static bool KERNEL(choose_cell)(const grid_t *grid, size_t *cell_id) {
+  const size_t size = KERNEL_GRID_SIZE(grid);
+  for (size_t count = 2; count <= size; count++) {
+    if (grid->bucket_heads[count] != NO_CELL) {
+      *cell_id = grid->bucket_heads[count];
+      return true;
+    }
+  }
+  return false;
+}
+
+/* backtracking search on a grid settled by the heuristics. a branch only
+ * changes its cell, so only the units of this cell are queued for the
+ * heuristics. the hooks of search (if not NULL) may stop it or take some of
+ * its branches over. */
+static size_t KERNEL(search)(grid_t *grid, const grid_search_t *search,
+                             unit_queue_t *queue) {
+  if (search != NULL && search->cancelled(search->data)) {
+    return 2;
+  }
+  size_t cell_id = 0;
+  if (!KERNEL(choose_cell)(grid, &cell_id)) {
+    return 2;
+  }
+
+  const cell_id_t *cell_units = units_of_cell(grid->units, cell_id);
+  COLORS_T choices = ((COLORS_T *)grid->cells)[cell_id];
+  size_t checkpoint = grid_checkpoint(grid);
+  while (!COLORS(is_empty)(choices)) {
+    COLORS_T choice = COLORS(rightmost)(choices);
+    choices = COLORS(subtract)(choices, choice);
+
+    KERNEL(update_cell)(grid, cell_id, choice);
+    /* the last branch is always searched here */
+    if (search == NULL || COLORS(is_empty)(choices) ||
+        !search->offer(grid, search->data)) {
+      for (size_t k = 0; k < 3; k++) {
+        unit_queue_push(queue, cell_units[k]);
+      }
+      size_t status = KERNEL(propagate)(grid, queue);
+      if (status == 0 ||
+          (status == 1 && KERNEL(search)(grid, search, queue) == 0)) {
+        return 0;
+      }
+    }
+    grid_rollback(grid, checkpoint);
+  }
+  return 2;
+}
+
+static size_t KERNEL(solve)(grid_t *grid, const grid_search_t *search) {
+  if (search != NULL && search->cancelled(search->data)) {
+    return 2;
+  }
+  size_t nb_units = grid->units->nb_units;
+  size_t unit_ids[nb_units];
+  bool queued[nb_units];
+  unit_queue_t queue = {unit_ids, queued, nb_units, 0, 0};
+  memset(queued, 0, sizeof(queued));
+  size_t status = KERNEL(propagate_all)(grid, &queue);
+  if (status != 1) {
+    return status;
+  }
+  return KERNEL(search)(grid, search, &queue);
+}
+
+static const grid_kernel_t KERNEL(kernel) = {
+#ifdef KERNEL_SIZE
+    .size = KERNEL_SIZE,
+#endif
+    .colors_size = sizeof(COLORS_T),
+    .max_colors = 8 * sizeof(COLORS_T),
+    .rollback = KERNEL(rollback),
+    .get_cell = KERNEL(get_cell),
+    .has_color = KERNEL(has_color),
+    .set_color = KERNEL(set_color),
+    .get_colors = KERNEL(get_colors),
+    .set_colors = KERNEL(set_colors),
+    .is_consistent = KERNEL(is_consistent),
+    .heuristics = KERNEL(heuristics),
+    .solve = KERNEL(solve),
+};
+
+#undef KERNEL_GRID_SIZE
+#undef KERNEL_GRID_BLOCK_SIZE
@@ -0,0 +1,108 @@
+#include "parallel.h"
+#include "grid.h"
+#include "pool.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <err.h>
+#include <pthread.h>
+
+/* a search shared by the workers of a pool, holding the first solution */
+typedef struct {
+  pool_t *pool;
+  atomic_bool solved;
+  pthread_mutex_t lock;
+  grid_t *solution;
+} parallel_t;
+
+/* a branch of the search, searched on its own copy of the grid */
+typedef struct {
+  parallel_t *parallel;
+  grid_t *grid;
+} parallel_task_t;
+
+static void parallel_run(void *arg);
+
+static void parallel_submit(parallel_t *parallel, grid_t *grid) {
+  parallel_task_t *task = malloc(sizeof(parallel_task_t));
+  if (task == NULL || grid == NULL) {
+    errx(EXIT_FAILURE, "can't allocate a task of the parallel search.");
+  }
+  task->parallel = parallel;
+  task->grid = grid;
+  pool_submit(parallel->pool, parallel_run, task);
+}
+
+static bool parallel_cancelled(void *data) {
+  parallel_t *parallel = data;
+  return atomic_load_explicit(&parallel->solved, memory_order_relaxed);
+}
+
+/* a branch is given to the pool only when a worker waits for one */
+static bool parallel_offer(const grid_t *grid, void *data) {
+  parallel_t *parallel = data;
+  if (!pool_is_hungry(parallel->pool)) {
+    return false;
+  }
+  parallel_submit(parallel, grid_copy(grid));
+  return true;
+}
+
+static void parallel_run(void *arg) {
+  parallel_task_t *task = arg;
+  parallel_t *parallel = task->parallel;
+  grid_search_t search = {parallel_cancelled, parallel_offer, parallel};
+  if (!parallel_cancelled(parallel) && grid_search(task->grid, &search) == 0) {
+    pthread_mutex_lock(&parallel->lock);
+    if (parallel->solution == NULL) {
+      parallel->solution = task->grid;
+      task->grid = NULL;
+      atomic_store(&parallel->solved, true);
+    }
+    pthread_mutex_unlock(&parallel->lock);
+  }
+  grid_free(task->grid);
+  free(task);
+}
+
+size_t parallel_solve(grid_t *grid, const size_t nb_threads) {
+  if (grid == NULL) {
+    return 2;
+  }
+  if (nb_threads <= 1) {
+    return grid_solve(grid);
+  }
+
+  /* the grid gets the root propagation as it would with grid_solve() */
+  size_t status = grid_heuristics(grid);
+  if (status != 1) {
+    return status;
+  }
+
+  parallel_t parallel;
+  parallel.pool = pool_alloc(nb_threads);
+  atomic_init(&parallel.solved, false);
+  pthread_mutex_init(&parallel.lock, NULL);
+  parallel.solution = NULL;
+  parallel_submit(&parallel, grid_copy(grid));
+  pool_free(parallel.pool);
+  pthread_mutex_destroy(&parallel.lock);
+
+  if (parallel.solution == NULL) {
+    return 2;
+  }
+  size_t size = grid_get_size(grid);
+  for (size_t row = 0; row < size; row++) {
+    for (size_t column = 0; column < size; column++) {
+      size_t color_id = 0;
+      while (!grid_has_color(parallel.solution, row, column, color_id)) {
+        color_id++;
+      }
+      grid_set_cell(grid, row, column, color_table[color_id]);
+    }
+  }
+  grid_free(parallel.solution);
+  return 0;
+}
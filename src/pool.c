@@ -0,0 +1,241 @@
+#include "pool.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <err.h>
+#include <pthread.h>
+
+typedef struct {
+  pool_run_t run;
+  void *arg;
+} pool_task_t;
+
+/* tasks of a worker in a ring buffer: the worker pushes and pops at the back,
+ * the other workers steal at the front */
+typedef struct {
+  pthread_mutex_t lock;
+  pool_task_t *tasks;
+  size_t head;
+  size_t length;
+  size_t capacity;
+} pool_deque_t;
+
+/* Internal structure (hiden from outside) to represent a thread pool */
+struct _pool_t {
+  size_t nb_threads;
+  pthread_t *threads;
+  pool_deque_t *deques;
+  /* tasks submitted and not run yet, tasks waiting in the deques and workers
+   * waiting for a task */
+  atomic_size_t pending;
+  atomic_size_t available;
+  atomic_size_t idle;
+  /* deque receiving the next task submitted from outside the pool */
+  atomic_size_t next_deque;
+  /* the workers wait on wakeup for tasks, pool_wait() on done */
+  pthread_mutex_t lock;
+  pthread_cond_t wakeup;
+  pthread_cond_t done;
+  bool stop;
+};
+
+/* the pool and the deque of the worker running in the current thread */
+typedef struct {
+  pool_t *pool;
+  size_t worker_id;
+} pool_worker_t;
+
+static _Thread_local pool_worker_t current_worker = {NULL, 0};
+
+static void pool_deque_push(pool_deque_t *deque, const pool_task_t task) {
+  pthread_mutex_lock(&deque->lock);
+  if (deque->length == deque->capacity) {
+    size_t capacity = deque->capacity == 0 ? 16 : 2 * deque->capacity;
+    pool_task_t *tasks = malloc(capacity * sizeof(pool_task_t));
+    if (tasks == NULL) {
+      errx(EXIT_FAILURE, "can't grow the tasks of the pool.");
+    }
+    for (size_t i = 0; i < deque->length; i++) {
+      tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+    }
+    free(deque->tasks);
+    deque->tasks = tasks;
+    deque->head = 0;
+    deque->capacity = capacity;
+  }
+  deque->tasks[(deque->head + deque->length) % deque->capacity] = task;
+  deque->length++;
+  pthread_mutex_unlock(&deque->lock);
+}
+
+/* take the newest task of a deque (or the oldest one if steal), returns
+ * false if it is empty */
+static bool pool_deque_take(pool_deque_t *deque, pool_task_t *task,
+                            const bool steal) {
+  pthread_mutex_lock(&deque->lock);
+  bool found = deque->length > 0;
+  if (found) {
+    if (steal) {
+      *task = deque->tasks[deque->head];
+      deque->head = (deque->head + 1) % deque->capacity;
+    } else {
+      *task =
+          deque->tasks[(deque->head + deque->length - 1) % deque->capacity];
+    }
+    deque->length--;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+/* the next task of a worker: its own newest one, or the oldest one of the
+ * other workers */
+static bool pool_take(pool_t *pool, const size_t worker_id,
+                      pool_task_t *task) {
+  bool found = pool_deque_take(&pool->deques[worker_id], task, false);
+  for (size_t i = 1; i < pool->nb_threads && !found; i++) {
+    size_t victim = (worker_id + i) % pool->nb_threads;
+    found = pool_deque_take(&pool->deques[victim], task, true);
+  }
+  if (found) {
+    atomic_fetch_sub(&pool->available, 1);
+  }
+  return found;
+}
+
+static void *pool_worker(void *arg) {
+  current_worker = *(pool_worker_t *)arg;
+  free(arg);
+  pool_t *pool = current_worker.pool;
+  size_t worker_id = current_worker.worker_id;
+  while (true) {
+    pool_task_t task;
+    if (pool_take(pool, worker_id, &task)) {
+      task.run(task.arg);
+      if (atomic_fetch_sub(&pool->pending, 1) == 1) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+      }
+      continue;
+    }
+
+    /* available is only raised before taking the lock to signal wakeup, so
+     * a task submitted meanwhile can't be missed */
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add(&pool->idle, 1);
+    while (atomic_load(&pool->available) == 0 && !pool->stop) {
+      pthread_cond_wait(&pool->wakeup, &pool->lock);
+    }
+    atomic_fetch_sub(&pool->idle, 1);
+    bool stop = pool->stop && atomic_load(&pool->available) == 0;
+    pthread_mutex_unlock(&pool->lock);
+    if (stop) {
+      return NULL;
+    }
+  }
+}
+
+pool_t *pool_alloc(const size_t nb_threads) {
+  pool_t *pool = malloc(sizeof(pool_t));
+  if (pool == NULL) {
+    errx(EXIT_FAILURE, "can't allocate memory for the pool !");
+  }
+  pool->nb_threads = nb_threads > 0 ? nb_threads : 1;
+  pool->threads = malloc(pool->nb_threads * sizeof(pthread_t));
+  pool->deques = calloc(pool->nb_threads, sizeof(pool_deque_t));
+  if (pool->threads == NULL || pool->deques == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the workers of the pool.");
+  }
+  atomic_init(&pool->pending, 0);
+  atomic_init(&pool->available, 0);
+  atomic_init(&pool->idle, 0);
+  atomic_init(&pool->next_deque, 0);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wakeup, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->stop = false;
+
+  for (size_t i = 0; i < pool->nb_threads; i++) {
+    pthread_mutex_init(&pool->deques[i].lock, NULL);
+  }
+  for (size_t i = 0; i < pool->nb_threads; i++) {
+    pool_worker_t *worker = malloc(sizeof(pool_worker_t));
+    if (worker == NULL) {
+      errx(EXIT_FAILURE, "can't allocate the workers of the pool.");
+    }
+    worker->pool = pool;
+    worker->worker_id = i;
+    if (pthread_create(&pool->threads[i], NULL, pool_worker, worker) != 0) {
+      errx(EXIT_FAILURE, "can't start the workers of the pool.");
+    }
+  }
+  return pool;
+}
+
+void pool_free(pool_t *pool) {
+  if (pool == NULL) {
+    return;
+  }
+
+  pool_wait(pool);
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->wakeup);
+  pthread_mutex_unlock(&pool->lock);
+  for (size_t i = 0; i < pool->nb_threads; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+
+  for (size_t i = 0; i < pool->nb_threads; i++) {
+    pthread_mutex_destroy(&pool->deques[i].lock);
+    free(pool->deques[i].tasks);
+  }
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->wakeup);
+  pthread_cond_destroy(&pool->done);
+  free(pool->deques);
+  free(pool->threads);
+  free(pool);
+}
+
+void pool_submit(pool_t *pool, pool_run_t run, void *arg) {
+  if (pool == NULL || run == NULL) {
+    return;
+  }
+
+  size_t deque_id = current_worker.worker_id;
+  if (current_worker.pool != pool) {
+    deque_id = atomic_fetch_add(&pool->next_deque, 1) % pool->nb_threads;
+  }
+  pool_task_t task = {run, arg};
+  atomic_fetch_add(&pool->pending, 1);
+  pool_deque_push(&pool->deques[deque_id], task);
+  atomic_fetch_add(&pool->available, 1);
+
+  pthread_mutex_lock(&pool->lock);
+  pthread_cond_signal(&pool->wakeup);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_wait(pool_t *pool) {
+  if (pool == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  while (atomic_load(&pool->pending) > 0) {
+    pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+bool pool_is_hungry(pool_t *pool) {
+  if (pool == NULL) {
+    return false;
+  }
+  return atomic_load_explicit(&pool->idle, memory_order_relaxed) >
+         atomic_load_explicit(&pool->available, memory_order_relaxed);
+}
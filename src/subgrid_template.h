@@ -0,0 +1,210 @@
+/* Heuristics applied to the cells of a unit, written once for every width of
+ * candidate sets. The file including it defines:
+ *  - COLORS_T: the type of the sets,
+ *  - COLORS(op): the name of the operation op on these sets,
+ *  - SUBGRID(name): the name given to the function name of this width.
+ * It may also define SUBGRID_SIZE to specialize SUBGRID(apply) for the units
+ * of a single size, which is then a compile-time constant for the
+ * heuristics. The locked sets search of the width, COLORS(locked_sets), is
+ * only defined by the instantiation defining SUBGRID_LOCKED_SETS. It reads
+ * the selected_heuristics and subset_max of colors.c. There is no include
+ * guard, it is included once per width and size. */
+
+#ifdef SUBGRID_SIZE
+#define SUBGRID_UNIT_SIZE(size) ((void)(size), (size_t)SUBGRID_SIZE)
+#else
+#define SUBGRID_UNIT_SIZE(size) (size)
+#endif
+
+static bool SUBGRID(cross_hatching)(COLORS_T *subgrid[], size_t size) {
+  bool cross_hatch = false;
+  for (size_t i = 0; i < size; i++) {
+    if (COLORS(is_singleton)(*(subgrid[i]))) {
+      for (size_t j = 0; j < size; j++) {
+        if (i != j) {
+          COLORS_T cell = COLORS(subtract)(*(subgrid[j]), *(subgrid[i]));
+          if (!COLORS(is_equal)(*(subgrid[j]), cell)) {
+            *(subgrid[j]) = cell;
+            cross_hatch = true;
+          }
+        }
+      }
+    }
+  }
+  return cross_hatch;
+}
+
+/* hidden singles: a color seen in only one cell of the unit is placed there.
+ * the colors seen at least once and at least twice are gathered in a single
+ * pass, so every hidden single of the unit is found at once. a cell which
+ * holds two of them is emptied to report the contradiction. */
+static bool SUBGRID(lone_number)(COLORS_T *subgrid[], size_t size) {
+  COLORS_T once = COLORS(empty)();
+  COLORS_T twice = COLORS(empty)();
+  for (size_t i = 0; i < size; i++) {
+    twice = COLORS(or)(twice, COLORS(and)(once, *(subgrid[i])));
+    once = COLORS(or)(once, *(subgrid[i]));
+  }
+  COLORS_T lone = COLORS(subtract)(once, twice);
+  if (COLORS(is_empty)(lone)) {
+    return false;
+  }
+
+  bool lone_numb = false;
+  for (size_t i = 0; i < size; i++) {
+    COLORS_T cell = *(subgrid[i]);
+    COLORS_T cell_lone = COLORS(and)(cell, lone);
+    if (COLORS(is_singleton)(cell_lone)) {
+      if (!COLORS(is_equal)(cell_lone, cell)) {
+        *(subgrid[i]) = cell_lone;
+        lone_numb = true;
+      }
+    } else if (!COLORS(is_empty)(cell_lone)) {
+      *(subgrid[i]) = COLORS(empty)();
+      lone_numb = true;
+    }
+  }
+  return lone_numb;
+}
+
+#ifdef SUBGRID_LOCKED_SETS
+/* look for the sets of k masks among masks[from..] with 2 to k colors each
+ * and exactly k colors in their union, extending a partial set of depth masks
+ * (members) with the given union (colors). the masks are pruned as soon as
+ * the union exceeds k colors. */
+static bool SUBGRID(locked_sets_search)(const COLORS_T masks[],
+                                        const size_t nb_masks,
+                                        const size_t from, const size_t k,
+                                        const size_t depth,
+                                        const COLORS_T members,
+                                        const COLORS_T colors,
+                                        COLORS(locked_set_found_t) found,
+                                        void *data) {
+  bool res = false;
+  for (size_t i = from; i + (k - depth) <= nb_masks; i++) {
+    size_t count = COLORS(count)(masks[i]);
+    if (count < 2 || count > k) {
+      continue;
+    }
+
+    COLORS_T new_colors = COLORS(or)(colors, masks[i]);
+    size_t new_count = COLORS(count)(new_colors);
+    if (new_count > k) {
+      continue;
+    }
+
+    COLORS_T new_members = COLORS(add)(members, i);
+    if (depth + 1 == k) {
+      if (new_count == k) {
+        res |= found(new_members, new_colors, data);
+      }
+    } else {
+      res |= SUBGRID(locked_sets_search)(masks, nb_masks, i + 1, k, depth + 1,
+                                         new_members, new_colors, found, data);
+    }
+  }
+  return res;
+}
+
+bool COLORS(locked_sets)(const COLORS_T masks[], const size_t nb_masks,
+                         const size_t max, COLORS(locked_set_found_t) found,
+                         void *data) {
+  bool res = false;
+  for (size_t k = 2; k <= max && k < nb_masks; k++) {
+    res |= SUBGRID(locked_sets_search)(masks, nb_masks, 0, k, 0,
+                                       COLORS(empty)(), COLORS(empty)(), found,
+                                       data);
+  }
+  return res;
+}
+#endif
+
+typedef struct {
+  COLORS_T **subgrid;
+  size_t size;
+} SUBGRID(ref_t);
+
+/* the colors of a naked subset can't go in the other cells of the unit */
+static bool SUBGRID(naked_subset_found)(const COLORS_T members,
+                                        const COLORS_T colors, void *data) {
+  SUBGRID(ref_t) *ref = data;
+  bool naked_sub = false;
+  COLORS(foreach)(i, COLORS(subtract)(COLORS(full)(ref->size), members)) {
+    COLORS_T cell = *(ref->subgrid[i]);
+    if (!COLORS(is_empty)(COLORS(and)(cell, colors))) {
+      *(ref->subgrid[i]) = COLORS(subtract)(cell, colors);
+      naked_sub = true;
+    }
+  }
+  return naked_sub;
+}
+
+/* k cells of the unit whose candidates hold only k colors together take
+ * these k colors, which are removed from the other cells */
+static bool SUBGRID(naked_subset)(COLORS_T *subgrid[], size_t size) {
+  COLORS_T masks[size];
+  for (size_t i = 0; i < size; i++) {
+    masks[i] = *(subgrid[i]);
+  }
+  SUBGRID(ref_t) ref = {subgrid, size};
+  return COLORS(locked_sets)(masks, size, subset_max,
+                             SUBGRID(naked_subset_found), &ref);
+}
+
+/* the cells of a hidden subset can only take the colors of the subset */
+static bool SUBGRID(hidden_subset_found)(const COLORS_T members,
+                                         const COLORS_T colors, void *data) {
+  SUBGRID(ref_t) *ref = data;
+  bool hidden_sub = false;
+  COLORS(foreach)(i, colors) {
+    COLORS_T cell = *(ref->subgrid[i]);
+    if (!COLORS(is_empty)(COLORS(subtract)(cell, members))) {
+      *(ref->subgrid[i]) = COLORS(and)(cell, members);
+      hidden_sub = true;
+    }
+  }
+  return hidden_sub;
+}
+
+/* k colors which can only go in the same k cells of the unit are the only
+ * candidates of these cells. the unit is transposed into the positions of
+ * each color so that the search is the one of the naked subsets. */
+static bool SUBGRID(hidden_subset)(COLORS_T *subgrid[], size_t size) {
+  COLORS_T positions[size];
+  for (size_t color_id = 0; color_id < size; color_id++) {
+    positions[color_id] = COLORS(empty)();
+  }
+  for (size_t i = 0; i < size; i++) {
+    COLORS(foreach)(color_id, *(subgrid[i])) {
+      positions[color_id] = COLORS(add)(positions[color_id], i);
+    }
+  }
+  SUBGRID(ref_t) ref = {subgrid, size};
+  return COLORS(locked_sets)(positions, size, subset_max,
+                             SUBGRID(hidden_subset_found), &ref);
+}
+
+bool SUBGRID(apply)(COLORS_T *subgrid[], const size_t unit_size,
+                    const unsigned heuristics) {
+  const size_t size = SUBGRID_UNIT_SIZE(unit_size);
+  bool res = false;
+  if (heuristics & HEURISTIC_CROSS_HATCHING) {
+    res |= SUBGRID(cross_hatching)(subgrid, size);
+  }
+  if (heuristics & HEURISTIC_LONE_NUMBER) {
+    res |= SUBGRID(lone_number)(subgrid, size);
+  }
+  if (heuristics & HEURISTIC_NAKED_SUBSET) {
+    res |= SUBGRID(naked_subset)(subgrid, size);
+  }
+  if (heuristics & HEURISTIC_HIDDEN_SUBSET) {
+    res |= SUBGRID(hidden_subset)(subgrid, size);
+  }
+  return res;
+}
+
+bool SUBGRID(heuristics)(COLORS_T *subgrid[], const size_t unit_size) {
+  return SUBGRID(apply)(subgrid, unit_size, selected_heuristics);
+}
+
+#undef SUBGRID_UNIT_SIZE
@@ -1,61 +1,227 @@
 #include "sudoku.h"
 #include "colors.h"
+#include "band.h"
+#include "batch.h"
+#include "bitplane.h"
+#include "dlx.h"
 #include "grid.h"
+#include "parallel.h"
+#include "pool.h"
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <dirent.h>
 #include <err.h>
+#include <errno.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
-#define MAX_GRID_SIZE 64
-
 static bool verbose = false;
 
-/* check if the given path is a regular file */
-static int is_file_or_directory(const char *path) {
-  struct stat path_to_file;
-  stat(path, &path_to_file);
-  return S_ISREG(path_to_file.st_mode);
+/* solving engines selectable with the 'engine' option */
+typedef enum { ENGINE_BACKTRACK, ENGINE_DLX, ENGINE_BITPLANE } engine_t;
+
+static engine_t engine = ENGINE_BACKTRACK;
+
+/* number of threads solving the grids, and searching them with the
+ * backtrack engine */
+static size_t nb_jobs = 1;
+
+/* size of the message of a grid file which can't be parsed */
+#define PARSE_ERROR_SIZE 128
+
+/* the grid files given to the solver in input order, then their grids and
+ * statuses. a grid file which can't be parsed has a NULL grid and its
+ * error message. */
+typedef struct {
+  char **paths;
+  grid_t **grids;
+  size_t *statuses;
+  char (*errors)[PARSE_ERROR_SIZE];
+  size_t nb_grids;
+  size_t capacity;
+} inputs_t;
+
+/* grid files solved by a task of the pool, with the threads of each search.
+ * done is set under tasks_lock once they are solved. */
+typedef struct {
+  inputs_t *inputs;
+  size_t first;
+  size_t count;
+  bool batch;
+  size_t jobs;
+  bool done;
+} solve_task_t;
+
+/* the main thread waits on tasks_done for the next task to print */
+static pthread_mutex_t tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tasks_done = PTHREAD_COND_INITIALIZER;
+
+static void inputs_add_file(inputs_t *inputs, const char *path) {
+  if (inputs->nb_grids == inputs->capacity) {
+    inputs->capacity = inputs->capacity == 0 ? 16 : 2 * inputs->capacity;
+    inputs->paths = realloc(inputs->paths, inputs->capacity * sizeof(char *));
+    if (inputs->paths == NULL) {
+      errx(EXIT_FAILURE, "can't allocate the input grids.");
+    }
+  }
+  char *path_copy = malloc(strlen(path) + 1);
+  if (path_copy == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the input grids.");
+  }
+  strcpy(path_copy, path);
+  inputs->paths[inputs->nb_grids] = path_copy;
+  inputs->nb_grids++;
+}
+
+static int compare_names(const void *name1, const void *name2) {
+  return strcmp(*(char *const *)name1, *(char *const *)name2);
+}
+
+/* add a grid file, or the '.sku' files of a directory and of its
+ * subdirectories in the order of their names. the entries of a directory
+ * which can't be read are skipped with a warning, and the symbolic links to
+ * directories aren't followed. */
+static void inputs_add(inputs_t *inputs, const char *path,
+                       const bool in_directory) {
+  struct stat path_stat;
+  if (in_directory) {
+    if (lstat(path, &path_stat) == -1) {
+      warnx("%s is not a file, skipped.", path);
+      return;
+    }
+    if (S_ISLNK(path_stat.st_mode)) {
+      if (stat(path, &path_stat) == -1) {
+        warnx("%s is a broken link, skipped.", path);
+        return;
+      }
+      if (S_ISDIR(path_stat.st_mode)) {
+        return;
+      }
+    }
+  } else if (stat(path, &path_stat) == -1) {
+    errx(EXIT_FAILURE, "%s is not a file.", path);
+  }
+
+  if (S_ISREG(path_stat.st_mode)) {
+    size_t length = strlen(path);
+    if (in_directory && (length < 4 || strcmp(path + length - 4, ".sku"))) {
+      return;
+    }
+    /* check if the file is readable */
+    if (access(path, R_OK) == -1) {
+      if (in_directory) {
+        warnx("%s has no read permission, skipped.", path);
+        return;
+      }
+      errx(EXIT_FAILURE, "%s has no read permission.", path);
+    }
+    inputs_add_file(inputs, path);
+    return;
+  }
+  if (!S_ISDIR(path_stat.st_mode)) {
+    if (in_directory) {
+      return;
+    }
+    errx(EXIT_FAILURE, "%s is not a file.", path);
+  }
+
+  DIR *dir = opendir(path);
+  if (dir == NULL) {
+    if (in_directory) {
+      warnx("%s has no read permission, skipped.", path);
+      return;
+    }
+    errx(EXIT_FAILURE, "%s has no read permission.", path);
+  }
+  char **names = NULL;
+  size_t nb_names = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    char *name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+    names = realloc(names, (nb_names + 1) * sizeof(char *));
+    if (name == NULL || names == NULL) {
+      errx(EXIT_FAILURE, "can't allocate the input grids.");
+    }
+    sprintf(name, "%s/%s", path, entry->d_name);
+    names[nb_names] = name;
+    nb_names++;
+  }
+  closedir(dir);
+
+  qsort(names, nb_names, sizeof(char *), compare_names);
+  for (size_t i = 0; i < nb_names; i++) {
+    inputs_add(inputs, names[i], true);
+    free(names[i]);
+  }
+  free(names);
 }
 
 /* display the version of the software when calling the 'version' option */
 static void display_version() {
   printf("sudoku %d.%d.%d\nSolve/generate sudoku grids"
-         "(possible sizes: 1, 4, 9, 16, 25, 36, 49, 64)\n",
+         "(possible sizes: 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144)\n",
          VERSION, SUBVERSION, REVISION);
 }
 
 /* display the help panel when calling the 'help' option */
 static void display_help() {
   printf(
-      "Usage: sudoku [-a|-o FILE |-v|-V|-h] FILE ...\n"
+      "Usage: sudoku [-a|-b|-j N|-o FILE|-e ENGINE|-v|-V|-h] FILE|DIR ...\n"
       "\t sudoku -g[SIZE] [-u|-o FILE|-v|-V|-h]\n"
-      "Solve or generate Sudoku grids of various sizes (1,4,9,16,25,36,49,64)"
-      "\n"
+      "Solve or generate Sudoku grids of various sizes "
+      "(1,4,9,16,25,36,49,64,81,100,121,144)\n"
       "-g[N], --generarte[=N]\t generate a grid of size NxN (default:9)\n"
       "-a, --all\t\tsearch for all possible solutions\n"
+      "-b, --batch\t\t propagate the 9x9 grids together, 16 at a time\n"
+      "-j N, --jobs=N\t\t solve with N threads, the grids side by side and "
+      "the search of each one (default: 1)\n"
       "-u,--unique\t\t generate a grid with unique solution\n"
       "-o FILE, --output FILE\t write result to FILE\n"
+      "-e ENGINE, --engine=ENGINE\t solving engine: backtrack (default), "
+      "dlx or bitplane\n"
       "-v, --verbose\t\t verbose output\n"
       "-V, --version\t\t display version and exit\n"
       "-h, --help\t\t display this help\n");
 }
 
-static grid_t *file_parser(char *file) {
+/* an error of file_parser(): the message is written in error, the file is
+ * closed and the grid freed. returns NULL. */
+static grid_t *parse_error(FILE *fd, grid_t *grid, char *error,
+                           const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  vsnprintf(error, PARSE_ERROR_SIZE, format, args);
+  va_end(args);
+  if (fd != NULL) {
+    fclose(fd);
+  }
+  grid_free(grid);
+  return NULL;
+}
+
+/* parse a grid file, returns NULL with a message in error (PARSE_ERROR_SIZE
+ * bytes) if it is not a valid grid. it may run on any thread. */
+static grid_t *file_parser(const char *file, char *error) {
   /*true if we saw a EOL while parsing */
   bool EOL = false;
   char first_row[MAX_GRID_SIZE];
-  struct _grid_t *grid;
+  struct _grid_t *grid = NULL;
 
   FILE *fd = fopen(file, "r");
   if (fd == NULL) {
-    err(EXIT_FAILURE, "null pointer for given file.");
+    return parse_error(fd, grid, error, "null pointer for given file.: %s",
+                       strerror(errno));
   }
 
   /* the row number of the grid */
@@ -65,7 +231,7 @@ static grid_t *file_parser(char *file) {
   int c;
   char tmp;
 
-  while ((c = (char)fgetc(fd)) != EOF) {
+  while ((c = fgetc(fd)) != EOF) {
     switch (c) {
     case ' ':
     case '\t':
@@ -83,16 +249,19 @@ static grid_t *file_parser(char *file) {
       if (row == 0) {
         grid = grid_alloc(row_size);
         if (grid == NULL) {
-          errx(EXIT_FAILURE, "error trying to allocate the grid.");
+          return parse_error(fd, grid, error,
+                             "error trying to allocate the grid.");
         }
       } else {
         if (row_size != grid_get_size(grid)) {
-          errx(EXIT_FAILURE, "the line %lu is malformed!", row + 1);
+          return parse_error(fd, grid, error, "the line %lu is malformed!",
+                             row + 1);
         }
       }
 
       if (row + 1 > grid_get_size(grid)) {
-        errx(EXIT_FAILURE, "row %lu exceeds the grid size", row + 1);
+        return parse_error(fd, grid, error, "row %lu exceeds the grid size",
+                           row + 1);
       }
 
       for (size_t column = 0; column < row_size; column++) {
@@ -100,15 +269,16 @@ static grid_t *file_parser(char *file) {
         if (grid_check_char(grid, tmp)) {
           grid_set_cell(grid, row, column, first_row[column]);
         } else {
-          errx(EXIT_FAILURE,
-               "wrong character %c at"
-               " line %lu",
-               c, row + 1);
+          return parse_error(fd, grid, error,
+                             "wrong character %c at"
+                             " line %lu",
+                             c, row + 1);
         }
       }
 
       if (row > grid_get_size(grid)) {
-        errx(EXIT_FAILURE, "the row number exceeds the grid size");
+        return parse_error(fd, grid, error,
+                           "the row number exceeds the grid size");
       }
 
       EOL = true;
@@ -117,6 +287,10 @@ static grid_t *file_parser(char *file) {
       break;
 
     default:
+      if (row_size == MAX_GRID_SIZE) {
+        return parse_error(fd, grid, error, "the line %lu is too long!",
+                           row + 1);
+      }
       first_row[row_size] = c;
       row_size++;
       EOL = false;
@@ -127,12 +301,13 @@ static grid_t *file_parser(char *file) {
     if (row == 0) {
       grid = grid_alloc(row_size);
       if (grid == NULL) {
-        errx(EXIT_FAILURE, "error trying to allocate the grid.");
+        return parse_error(fd, grid, error,
+                           "error trying to allocate the grid.");
       }
     }
 
     if (row_size != grid_get_size(grid)) {
-      errx(EXIT_FAILURE, "the line %lu is malformed!", row);
+      return parse_error(fd, grid, error, "the line %lu is malformed!", row);
     }
 
     for (size_t i = 0; i < grid_get_size(grid); i++) {
@@ -140,29 +315,99 @@ static grid_t *file_parser(char *file) {
       if (grid_check_char(grid, tmp)) {
         grid_set_cell(grid, row, i, first_row[i]);
       } else {
-        errx(EXIT_FAILURE,
-             "wrong character %c at"
-             "line %lu",
-             c, row + 1);
+        return parse_error(fd, grid, error,
+                           "wrong character %c at"
+                           "line %lu",
+                           c, row + 1);
       }
     }
     row++;
   }
 
   if (row != grid_get_size(grid)) {
-    errx(EXIT_FAILURE, "Wrong number of rows");
+    return parse_error(fd, grid, error, "Wrong number of rows");
   }
 
   if (row > MAX_GRID_SIZE) {
-    errx(EXIT_FAILURE, "the last row exceeds the max grid size allowed.");
+    return parse_error(fd, grid, error,
+                       "the last row exceeds the max grid size allowed.");
   }
 
   fclose(fd);
   return grid;
 }
 
+/* solve a grid with the selected engine, the backtrack one searching with
+ * the given number of threads. returns the status of the grid. */
+static size_t solve_grid(grid_t *grid, const size_t jobs) {
+  if (engine == ENGINE_DLX) {
+    return dlx_solve(grid);
+  }
+  if (engine == ENGINE_BITPLANE) {
+    return bitplane_solve(grid);
+  }
+  if (grid_get_size(grid) == 9) {
+    /* the 9x9 grids have their own backtracking on fixed-size bands */
+    return band_solve(grid);
+  }
+  return parallel_solve(grid, jobs);
+}
+
+/* parse and solve the grid files of a task, the grids which can't be parsed
+ * are left NULL */
+static void solve_files(void *arg) {
+  solve_task_t *task = arg;
+  inputs_t *inputs = task->inputs;
+  for (size_t i = task->first; i < task->first + task->count; i++) {
+    inputs->grids[i] = file_parser(inputs->paths[i], inputs->errors[i]);
+  }
+  if (task->batch) {
+    batch_solve(inputs->grids + task->first, inputs->statuses + task->first,
+                task->count);
+  } else {
+    for (size_t i = task->first; i < task->first + task->count; i++) {
+      if (inputs->grids[i] != NULL) {
+        inputs->statuses[i] = solve_grid(inputs->grids[i], task->jobs);
+      }
+    }
+  }
+
+  pthread_mutex_lock(&tasks_lock);
+  task->done = true;
+  pthread_cond_signal(&tasks_done);
+  pthread_mutex_unlock(&tasks_lock);
+}
+
+/* print the grids of a solved task and free them, the first grid file which
+ * couldn't be parsed ends the program. returns false if a grid is
+ * inconsistent. */
+static bool print_files(const solve_task_t *task, FILE *output_fd) {
+  inputs_t *inputs = task->inputs;
+  bool solved = true;
+  for (size_t i = task->first; i < task->first + task->count; i++) {
+    if (inputs->grids[i] == NULL) {
+      errx(EXIT_FAILURE, "%s", inputs->errors[i]);
+    }
+    if (inputs->statuses[i] == 2) {
+      warnx("grid is inconstent !\n");
+      solved = false;
+    } else if (inputs->statuses[i] == 0) {
+      printf("grid is consistent and solved !\n");
+    } else {
+      warnx("grid is consistent but not solved !\n");
+    }
+    grid_print(inputs->grids[i], output_fd);
+    grid_free(inputs->grids[i]);
+    inputs->grids[i] = NULL;
+    free(inputs->paths[i]);
+  }
+  fflush(output_fd);
+  return solved;
+}
+
 int main(int argc, char *argv[]) {
   bool all = false;
+  bool batch = false;
   bool gen_bool = false;
   bool unique = false;
   bool version = false;
@@ -173,14 +418,17 @@ int main(int argc, char *argv[]) {
   /* options descriptor */
   const struct option long_opts[] = {{"generate", optional_argument, NULL, 'g'},
                                      {"all", no_argument, NULL, 'a'},
+                                     {"batch", no_argument, NULL, 'b'},
+                                     {"jobs", required_argument, NULL, 'j'},
                                      {"unique", no_argument, NULL, 'u'},
                                      {"output", required_argument, NULL, 'o'},
+                                     {"engine", required_argument, NULL, 'e'},
                                      {"verbose", no_argument, NULL, 'v'},
                                      {"version", no_argument, NULL, 'V'},
                                      {"help", no_argument, NULL, 'h'},
                                      {NULL, 0, NULL, 0}};
-  while ((optc = getopt_long(argc, argv, "g::auo:vVh", long_opts, NULL)) !=
-         -1) {
+  while ((optc = getopt_long(argc, argv, "g::abj:uo:e:vVh", long_opts,
+                             NULL)) != -1) {
     switch (optc) {
     case 'g': /* generate */
       if (optarg) {
@@ -195,6 +443,10 @@ int main(int argc, char *argv[]) {
         case 36:
         case 49:
         case 64:
+        case 81:
+        case 100:
+        case 121:
+        case 144:
           break;
         default:
           errx(EXIT_FAILURE, "%d isn't a valid size !", optnb);
@@ -205,6 +457,15 @@ int main(int argc, char *argv[]) {
     case 'a': /* all */
       all = true;
       break;
+    case 'b': /* batch */
+      batch = true;
+      break;
+    case 'j': /* jobs */
+      if (atoi(optarg) < 1) {
+        errx(EXIT_FAILURE, "%s isn't a valid number of jobs !", optarg);
+      }
+      nb_jobs = atoi(optarg);
+      break;
     case 'u': /* unique */
       unique = true;
       break;
@@ -222,6 +483,18 @@ int main(int argc, char *argv[]) {
       }
       break;
 
+    case 'e': /* engine */
+      if (strcmp(optarg, "backtrack") == 0) {
+        engine = ENGINE_BACKTRACK;
+      } else if (strcmp(optarg, "dlx") == 0) {
+        engine = ENGINE_DLX;
+      } else if (strcmp(optarg, "bitplane") == 0) {
+        engine = ENGINE_BITPLANE;
+      } else {
+        errx(EXIT_FAILURE, "%s isn't a valid engine !", optarg);
+      }
+      break;
+
     case 'v': /* verbose */
       verbose = true;
       break;
@@ -257,42 +530,78 @@ int main(int argc, char *argv[]) {
       warnx("'unique' conflicts with the solver mode, disabling it !");
     }
 
+    if (batch && engine != ENGINE_BACKTRACK) {
+      warnx("'batch' only runs the backtrack engine, disabling it !");
+      batch = false;
+    }
+
     if (optind == argc && help == false && version == false) {
       errx(EXIT_FAILURE, "error: no input grid given !");
     }
-    /* directory and file related checkings */
-    int optindex = optind;
-    char *arg_path;
-    while (optindex < argc) {
-      arg_path = argv[optindex];
-      /* check if the path is a valid regular file */
-      if (is_file_or_directory(arg_path)) {
-        /* check if the file is readable */
-        if (access(arg_path, R_OK) == -1) {
-          errx(EXIT_FAILURE, "%s has no read permission.", arg_path);
-        }
-        optindex++;
-      } else {
-        errx(EXIT_FAILURE, "%s is not a file.", arg_path);
-      }
+    /* directory and file related checkings, the grids are printed in input
+     * order, each one as soon as it and the ones before are solved */
+    inputs_t inputs = {NULL, NULL, NULL, NULL, 0, 0};
+    for (int i = optind; i < argc; i++) {
+      inputs_add(&inputs, argv[i], false);
+    }
+    size_t nb_grids = inputs.nb_grids;
+    if (nb_grids == 0) {
+      errx(EXIT_FAILURE, "error: no input grid given !");
+    }
+    inputs.grids = malloc(nb_grids * sizeof(grid_t *));
+    inputs.statuses = malloc(nb_grids * sizeof(size_t));
+    inputs.errors = malloc(nb_grids * PARSE_ERROR_SIZE);
+    /* a task solves a grid, or a batch of BATCH_LANES grids whose output is
+     * flushed once they are solved, even with a single thread */
+    size_t chunk = batch ? BATCH_LANES : 1;
+    size_t nb_tasks = (nb_grids + chunk - 1) / chunk;
+    solve_task_t *tasks = malloc(nb_tasks * sizeof(solve_task_t));
+    if (inputs.grids == NULL || inputs.statuses == NULL ||
+        inputs.errors == NULL || tasks == NULL) {
+      errx(EXIT_FAILURE, "can't allocate the input grids.");
+    }
+    for (size_t i = 0; i < nb_tasks; i++) {
+      size_t first = i * chunk;
+      size_t count = nb_grids - first < chunk ? nb_grids - first : chunk;
+      tasks[i] = (solve_task_t){&inputs, first, count, batch, nb_jobs, false};
+    }
 
-      struct _grid_t *output_grid;
-      output_grid = file_parser(arg_path);
-      if (grid_heuristics(output_grid) == 2) {
-        warnx("grid is inconstent !\n");
-        grid_print(output_grid, output_fd);
-        grid_free(output_grid);
-        solved = false;
-      } else if (!grid_heuristics(output_grid) == 1) {
-        printf("grid is consistent and solved !\n");
-        grid_print(output_grid, output_fd);
-        grid_free(output_grid);
-      } else {
-        warnx("grid is consistent but not solved !\n");
-        grid_print(output_grid, output_fd);
-        grid_free(output_grid);
+    if (nb_jobs == 1 || nb_tasks <= 1) {
+      for (size_t i = 0; i < nb_tasks; i++) {
+        solve_files(&tasks[i]);
+        solved &= print_files(&tasks[i], output_fd);
       }
+    } else {
+      /* the tasks are solved side by side, at most 2 per thread ahead of the
+       * next one to print so that only their grids are in memory. the
+       * threads left when there are fewer tasks than threads go to the
+       * search of each grid. */
+      size_t nb_threads = nb_jobs < nb_tasks ? nb_jobs : nb_tasks;
+      size_t jobs = nb_jobs > nb_tasks ? nb_jobs / nb_tasks : 1;
+      size_t window = 2 * nb_threads;
+      size_t nb_submitted = 0;
+      pool_t *pool = pool_alloc(nb_threads);
+      for (size_t i = 0; i < nb_tasks; i++) {
+        while (nb_submitted < nb_tasks && nb_submitted < i + window) {
+          tasks[nb_submitted].jobs = jobs;
+          pool_submit(pool, solve_files, &tasks[nb_submitted]);
+          nb_submitted++;
+        }
+        pthread_mutex_lock(&tasks_lock);
+        while (!tasks[i].done) {
+          pthread_cond_wait(&tasks_done, &tasks_lock);
+        }
+        pthread_mutex_unlock(&tasks_lock);
+        solved &= print_files(&tasks[i], output_fd);
+      }
+      pool_free(pool);
     }
+
+    free(tasks);
+    free(inputs.paths);
+    free(inputs.grids);
+    free(inputs.statuses);
+    free(inputs.errors);
     if (solved == false) {
       return EXIT_FAILURE;
     }
@@ -0,0 +1,72 @@
+#include "units.h"
+#include "grid.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <err.h>
+#include <pthread.h>
+
+/* square root of MAX_GRID_SIZE */
+#define MAX_BLOCK_SIZE 12
+
+/* tables indexed by block size, filled on first use. the grids may be
+ * allocated by several threads, the tables are filled under a lock. */
+static units_t units_tables[MAX_BLOCK_SIZE + 1];
+static pthread_mutex_t units_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void units_build(units_t *units, const size_t block_size) {
+  size_t size = block_size * block_size;
+  size_t nb_cells = size * size;
+
+  units->size = size;
+  units->block_size = block_size;
+  units->nb_units = 3 * size;
+  units->cells = malloc(units->nb_units * size * sizeof(cell_id_t));
+  units->cell_units = malloc(3 * nb_cells * sizeof(cell_id_t));
+  units->cell_positions = malloc(3 * nb_cells * sizeof(cell_id_t));
+  if (units->cells == NULL || units->cell_units == NULL ||
+      units->cell_positions == NULL) {
+    errx(EXIT_FAILURE, "can't allocate the unit tables of size %zu.", size);
+  }
+
+  for (size_t row = 0; row < size; row++) {
+    for (size_t column = 0; column < size; column++) {
+      size_t cell_id = row * size + column;
+      size_t block = (row / block_size) * block_size + column / block_size;
+      size_t block_cell =
+          (row % block_size) * block_size + column % block_size;
+
+      units->cells[row * size + column] = cell_id;
+      units->cells[(size + column) * size + row] = cell_id;
+      units->cells[(2 * size + block) * size + block_cell] = cell_id;
+
+      units->cell_units[cell_id * 3] = row;
+      units->cell_units[cell_id * 3 + 1] = size + column;
+      units->cell_units[cell_id * 3 + 2] = 2 * size + block;
+
+      units->cell_positions[cell_id * 3] = column;
+      units->cell_positions[cell_id * 3 + 1] = row;
+      units->cell_positions[cell_id * 3 + 2] = block_cell;
+    }
+  }
+}
+
+const units_t *units_get(const size_t size) {
+  if (!grid_check_size(size)) {
+    return NULL;
+  }
+
+  size_t block_size = 1;
+  while (block_size * block_size < size) {
+    block_size++;
+  }
+
+  units_t *units = &units_tables[block_size];
+  pthread_mutex_lock(&units_lock);
+  if (units->cells == NULL) {
+    units_build(units, block_size);
+  }
+  pthread_mutex_unlock(&units_lock);
+  return units;
+}
@@ -0,0 +1,108 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <band.h>
+#include <colors.h>
+#include <grid.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c band_tests.c */
+/* gcc -o band_tests band_tests.o tests_utils.o band.o grid.o colors.o
+ * units.o */
+
+int
+main (void)
+{
+  fputs ("Testing NULL grids\n"
+	 "==================\n", stdout);
+
+  EXPECT ((band_solve (NULL) == 2), "band_solve(NULL) == 2");
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing band_solve\n"
+	 "==================\n", stdout);
+
+  const char *puzzle =
+    "_____59_6" "_______7_" "_9_46_52_"
+    "_6_____9_" "1___86__5" "_8_3____1"
+    "_14_____7" "3___5____" "__69____3";
+
+  grid_t *grid = grid_from_string (9, puzzle);
+  grid_t *expected = grid_from_string (9, puzzle);
+  EXPECT ((band_solve (grid) == 0), "band_solve(grid) == 0");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+  grid_solve (expected);
+  EXPECT ((grid_equal (grid, expected)),
+	  "band_solve(grid) == grid_solve(grid)");
+  grid_free (expected);
+  grid_free (grid);
+
+  grid = grid_alloc (9);
+  for (size_t i = 0; i < 9; ++i)
+    for (size_t j = 0; j < 9; ++j)
+      grid_set_cell (grid, i, j, EMPTY_CELL);
+  EXPECT ((band_solve (grid) == 0), "band_solve(empty 9x9) == 0");
+  EXPECT ((grid_is_solved (grid) && grid_is_consistent (grid)),
+	  "band_solve(empty 9x9) is solved and consistent");
+  grid_free (grid);
+
+  grid = grid_from_string (9,
+			   "1_______1" "_________" "_________"
+			   "_________" "_________" "_________"
+			   "_________" "_________" "_________");
+  EXPECT ((band_solve (grid) == 2), "band_solve(inconsistent grid) == 2");
+  grid_free (grid);
+
+  /* the cell (0, 8) can only take the 9, already in its column */
+  grid = grid_from_string (9,
+			   "12345678_" "_________" "_________"
+			   "_________" "_________" "________9"
+			   "_________" "_________" "_________");
+  EXPECT ((band_solve (grid) == 2), "band_solve(unsolvable grid) == 2");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1___" "____" "____" "___1");
+  EXPECT ((band_solve (grid) == 0 && grid_is_solved (grid)),
+	  "band_solve(4x4 grid) == grid_solve(4x4 grid) == 0");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing band_solve_cells\n"
+	 "========================\n", stdout);
+
+  char cells[82];
+  strcpy (cells, puzzle);
+  grid = grid_from_string (9, puzzle);
+  band_solve (grid);
+  EXPECT ((band_solve_cells (cells) == 0), "band_solve_cells(cells) == 0");
+  expected = grid_from_string (9, cells);
+  EXPECT ((grid_equal (grid, expected)),
+	  "band_solve_cells(cells) == band_solve(grid)");
+  grid_free (expected);
+  grid_free (grid);
+
+  strcpy (cells,
+	  "1_______1" "_________" "_________"
+	  "_________" "_________" "_________"
+	  "_________" "_________" "_________");
+  EXPECT ((band_solve_cells (cells) == 2),
+	  "band_solve_cells(inconsistent cells) == 2");
+
+  strcpy (cells,
+	  "1_______A" "_________" "_________"
+	  "_________" "_________" "_________"
+	  "_________" "_________" "_________");
+  EXPECT ((band_solve_cells (cells) == 2),
+	  "band_solve_cells(cells with a wrong color) == 2");
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <batch.h>
+#include <colors.h>
+#include <grid.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c batch_tests.c */
+/* gcc -o batch_tests batch_tests.o tests_utils.o batch.o band.o grid.o
+ * colors.o units.o */
+
+int
+main (void)
+{
+  fputs ("Testing batch_solve\n"
+	 "===================\n", stdout);
+
+  /* solved by the propagation alone or by the search, inconsistent, of
+   * another size and NULL, with more grids than lanes */
+  const char *easy =
+    "53__7____" "6__195___" "_98____6_"
+    "8___6___3" "4__8_3__1" "7___2___6"
+    "_6____28_" "___419__5" "____8__79";
+  const char *hard =
+    "_____59_6" "_______7_" "_9_46_52_"
+    "_6_____9_" "1___86__5" "_8_3____1"
+    "_14_____7" "3___5____" "__69____3";
+  const char *inconsistent =
+    "1_______1" "_________" "_________"
+    "_________" "_________" "_________"
+    "_________" "_________" "_________";
+  size_t nb_grids = BATCH_LANES + 5;
+  grid_t *grids[BATCH_LANES + 5];
+  size_t statuses[BATCH_LANES + 5];
+  for (size_t i = 0; i < nb_grids; ++i)
+    grids[i] = grid_from_string (9, i % 3 == 0 ? easy : hard);
+  grid_free (grids[4]);
+  grids[4] = grid_from_string (9, inconsistent);
+  grid_free (grids[7]);
+  grids[7] = grid_from_string (4, "1___" "____" "____" "___1");
+  grid_free (grids[8]);
+  grids[8] = NULL;
+
+  batch_solve (grids, statuses, nb_grids);
+
+  bool all_solved = true;
+  for (size_t i = 0; i < nb_grids; ++i)
+    if (i != 4 && i != 8
+	&& (statuses[i] != 0 || !grid_is_solved (grids[i])
+	    || !grid_is_consistent (grids[i])))
+      all_solved = false;
+  EXPECT ((all_solved), "batch_solve(easy and hard grids) solves them all");
+  EXPECT ((statuses[4] == 2), "batch_solve(inconsistent grid) == 2");
+  EXPECT ((statuses[8] == 2), "batch_solve(NULL grid) == 2");
+
+  grid_t *expected = grid_from_string (9, hard);
+  grid_solve (expected);
+  EXPECT ((grid_equal (grids[1], expected)),
+	  "batch_solve(hard grid) == grid_solve(hard grid)");
+  grid_free (expected);
+  expected = grid_from_string (9, easy);
+  grid_solve (expected);
+  EXPECT ((grid_equal (grids[BATCH_LANES + 2], expected)),
+	  "batch_solve(easy grid) == grid_solve(easy grid)");
+  grid_free (expected);
+
+  for (size_t i = 0; i < nb_grids; ++i)
+    grid_free (grids[i]);
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <bitplane.h>
+#include <colors.h>
+#include <dlx.h>
+#include <grid.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c bitplane_tests.c */
+/* gcc -o bitplane_tests bitplane_tests.o tests_utils.o bitplane.o dlx.o
+ * grid.o colors.o units.o */
+
+int
+main (void)
+{
+  fputs ("Testing NULL grids\n"
+	 "==================\n", stdout);
+
+  EXPECT ((bitplane_solve (NULL) == 2), "bitplane_solve(NULL) == 2");
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing bitplane_solve\n"
+	 "======================\n", stdout);
+
+  const char *puzzle =
+    "_____59_6" "_______7_" "_9_46_52_"
+    "_6_____9_" "1___86__5" "_8_3____1"
+    "_14_____7" "3___5____" "__69____3";
+
+  grid_t *grid = grid_from_string (9, puzzle);
+  grid_t *expected = grid_from_string (9, puzzle);
+  EXPECT ((bitplane_solve (grid) == 0), "bitplane_solve(grid) == 0");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+  dlx_solve (expected);
+  EXPECT ((grid_equal (grid, expected)),
+	  "bitplane_solve(grid) == dlx_solve(grid)");
+  grid_free (expected);
+  grid_free (grid);
+
+  /* a 16x16 grid spans several words of the bitboards */
+  grid = grid_alloc (16);
+  for (size_t i = 0; i < 16; ++i)
+    for (size_t j = 0; j < 16; ++j)
+      grid_set_cell (grid, i, j, EMPTY_CELL);
+  EXPECT ((bitplane_solve (grid) == 0), "bitplane_solve(empty 16x16) == 0");
+  EXPECT ((grid_is_solved (grid) && grid_is_consistent (grid)),
+	  "bitplane_solve(empty 16x16) is solved and consistent");
+  grid_free (grid);
+
+  /* the rows of a 81x81 grid span two words, the blocks of the columns 63
+   * to 71 span both. the heuristics leave the empty corner to the search. */
+  grid = grid_alloc (81);
+  for (size_t i = 0; i < 81; ++i)
+    for (size_t j = 0; j < 81; ++j)
+      {
+	size_t color_id = (9 * (i % 9) + i / 9 + j) % 81;
+	grid_set_cell (grid, i, j,
+		       (i < 9 && j >= 54) ? EMPTY_CELL : color_table[color_id]);
+      }
+  EXPECT ((bitplane_solve (grid) == 0), "bitplane_solve(81x81 grid) == 0");
+  EXPECT ((grid_is_solved (grid) && grid_is_consistent (grid)),
+	  "bitplane_solve(81x81 grid) is solved and consistent");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1__1" "____" "____" "____");
+  EXPECT ((bitplane_solve (grid) == 2),
+	  "bitplane_solve(inconsistent grid) == 2");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1___" "2___" "3___" "___4");
+  EXPECT ((bitplane_solve (grid) == 2),
+	  "bitplane_solve(unsolvable grid) == 2");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
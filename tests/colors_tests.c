@@ -2,48 +2,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#include <stdarg.h>
 #include <string.h>
 
 #include <colors.h>
+#include <colors_narrow.h>
+#include <colors_wide.h>
 
-/* gcc -I ../include -c colors_tests.c */
-/* gcc -o colors_tests colors_tests.o colors.o */
-
-void
-EXPECT (bool test, char *fmt, ...)
-{
-  fprintf (stdout, "Checking '");
-
-  va_list vargs;
-  va_start(vargs, fmt);
-  vprintf(fmt, vargs);
-  va_end(vargs);
-
-  if (test)
-    fprintf (stdout, "': (passed)\n");
-  else
-    fprintf (stdout, "': (failed!)\n");
-}
-
-void
-ASSERT (bool test, char *fmt, ...)
-{
-  fprintf (stdout, "Checking '");
+#include "tests_utils.h"
 
-  va_list vargs;
-  va_start(vargs, fmt);
-  vprintf(fmt, vargs);
-  va_end(vargs);
-
-  if (test)
-    fprintf (stdout, "': (passed)\n");
-  else
-    {
-      fprintf (stdout, "': (critical fail!) aborting...\n");
-      exit (EXIT_FAILURE);
-    }
-}
+/* gcc -I ../include -c colors_tests.c */
+/* gcc -o colors_tests colors_tests.o tests_utils.o colors.o grid.o units.o */
 
 int
 main (void)
@@ -72,7 +40,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_empty */
   /************************/
   fputs ("colors_empty\n"
@@ -82,7 +49,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_set */
   /**********************/
   fputs ("colors_set\n"
@@ -99,7 +65,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_add */
   /**********************/
   fputs ("colors_add\n"
@@ -126,7 +91,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_discard */
   /**************************/
   fputs ("colors_discard\n"
@@ -163,7 +127,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_is_in */
   /***************************/
   fputs ("colors_is_in\n"
@@ -219,7 +182,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_negate */
   /*************************/
   fputs ("colors_negate\n"
@@ -242,7 +204,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_and */
   /**********************/
   fputs ("colors_and\n"
@@ -282,7 +243,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_or */
   /*********************/
   fputs ("colors_or\n"
@@ -308,7 +268,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_xor */
   /**********************/
   fputs ("colors_xor\n"
@@ -350,7 +309,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_subtract */
   /***************************/
   fputs ("colors_subtract\n"
@@ -386,7 +344,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_is_equal */
   /***************************/
   fputs ("colors_is_equal\n"
@@ -420,7 +377,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_is_subset */
   /***************************/
   fputs ("colors_is_subset\n"
@@ -469,7 +425,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_is_singleton */
   /*******************************/
   fputs ("colors_is_singleton\n"
@@ -495,7 +450,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_count */
   /************************/
   fputs ("colors_count\n"
@@ -553,7 +507,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_rightmost */
   /****************************/
   fputs ("colors_rightmost\n"
@@ -582,7 +535,6 @@ main (void)
 
   fputs ("\n", stdout);
 
-
   /* Testing colors_leftmost */
   /***************************/
   fputs ("colors_leftmost\n"
@@ -610,6 +562,59 @@ main (void)
 	  "colors_leftmost ([]) == []");
 
   fputs ("\n", stdout);
+
+  /* Testing colors_rightmost_id */
+  /*******************************/
+  fputs ("colors_rightmost_id\n"
+	 "===================\n", stdout);
+
+  EXPECT ((colors_rightmost_id (p0) == 1),
+	  "colors_rightmost_id ([1,2,3,5,7,27,60]) == 1");
+
+  EXPECT ((colors_rightmost_id (colors_set (0)) == 0),
+	  "colors_rightmost_id ([0]) == 0");
+
+  EXPECT ((colors_rightmost_id (colors_set (63)) == 63),
+	  "colors_rightmost_id ([63]) == 63");
+
+  fputs ("\n", stdout);
+
+  /* Testing colors_next and colors_foreach */
+  /******************************************/
+  fputs ("colors_next, colors_foreach\n"
+	 "===========================\n", stdout);
+
+  colors_t rest = colors_add (colors_set (3), 63);
+  EXPECT ((colors_next (&rest) == 3 && rest == colors_set (63)),
+	  "colors_next ([3,63]) == 3, leaving [63]");
+  EXPECT ((colors_next (&rest) == 63 && rest == colors_empty ()),
+	  "colors_next ([63]) == 63, leaving []");
+
+  colors_t visited = colors_empty ();
+  size_t nb_visited = 0;
+  colors_foreach (color_id, p0)
+    {
+      visited = colors_add (visited, color_id);
+      nb_visited++;
+    }
+  EXPECT ((visited == p0 && nb_visited == 7),
+	  "colors_foreach ([1,2,3,5,7,27,60]) visits its 7 colors");
+
+  nb_visited = 0;
+  colors_foreach (color_id, colors_empty ())
+    nb_visited += color_id + 1;
+  EXPECT ((nb_visited == 0), "colors_foreach ([]) visits nothing");
+
+  nb_visited = 0;
+  colors_foreach (color_id, p0)
+    {
+      if (color_id == 5)
+	break;
+      nb_visited++;
+    }
+  EXPECT ((nb_visited == 3), "colors_foreach ([1,2,3,5,...]) stops on break");
+
+  fputs ("\n", stdout);
   
   /* Testing colors_random */
   /*************************/
@@ -642,5 +647,254 @@ main (void)
 
   fputs ("\n", stdout);
 
+  /* Testing the narrow colors */
+  /*****************************/
+  fputs ("colors16, colors32\n"
+	 "==================\n", stdout);
+
+  EXPECT ((colors16_full (16) == 0xffff && colors16_full (9) == 0x1ff),
+	  "colors16_full (16) == [0, ... ,15]");
+  EXPECT ((colors32_count (colors32_full (25)) == 25
+	   && colors32_full (32) == 0xffffffff),
+	  "colors32_count (colors32_full (25)) == 25");
+  EXPECT ((colors16_set (16) == 0 && !colors16_is_in (0xffff, 16)),
+	  "colors16_set (16) == []");
+  EXPECT ((colors16_negate (colors16_set (3)) == 0xfff7),
+	  "colors16_negate ([3]) == [0,1,2,4, ... ,15]");
+
+  colors32_t n1 = colors32_add (colors32_set (2), 24);
+  EXPECT ((colors32_rightmost_id (n1) == 2
+	   && colors32_leftmost (n1) == colors32_set (24)),
+	  "colors32_rightmost/leftmost ([2,24]) == 2, 24");
+  EXPECT ((colors32_is_singleton (colors32_discard (n1, 2))
+	   && colors32_is_subset (colors32_set (24), n1)),
+	  "colors32_discard ([2,24], 2) == [24]");
+
+  size_t narrow_ids[3];
+  size_t nb_narrow = 0;
+  colors16_foreach (color_id, colors16_add (colors16_set (0), 15))
+    if (nb_narrow < 3)
+      narrow_ids[nb_narrow++] = color_id;
+  EXPECT ((nb_narrow == 2 && narrow_ids[0] == 0 && narrow_ids[1] == 15),
+	  "colors16_foreach ([0,15]) visits 0, 15");
+
+  fputs ("\n", stdout);
+
+  /* Testing the wide colors */
+  /***************************/
+  fputs ("colors128, colors256\n"
+	 "====================\n", stdout);
+
+  EXPECT ((colors128_count (colors128_full (81)) == 81),
+	  "colors128_count (colors128_full (81)) == 81");
+  EXPECT ((colors256_count (colors256_full (144)) == 144),
+	  "colors256_count (colors256_full (144)) == 144");
+  EXPECT ((colors256_is_in (colors256_full (144), 143)
+	   && !colors256_is_in (colors256_full (144), 144)),
+	  "colors256_full (144) == [0, ... ,143]");
+
+  colors128_t w1 = colors128_add (colors128_set (3), 100);
+  EXPECT ((colors128_rightmost_id (w1) == 3
+	   && colors128_is_equal (colors128_leftmost (w1),
+				  colors128_set (100))),
+	  "colors128_rightmost/leftmost ([3,100]) == 3, 100");
+  EXPECT ((colors128_is_singleton (colors128_discard (w1, 3))
+	   && colors128_is_empty (colors128_subtract (w1, w1))),
+	  "colors128_discard ([3,100], 3) == [100]");
+  EXPECT ((colors128_is_subset (colors128_set (100), w1)
+	   && !colors128_is_subset (colors128_set (64), w1)),
+	  "colors128_is_subset ([100], [3,100]) == true");
+
+  colors256_t w2 = colors256_add (colors256_add (colors256_set (0), 127), 200);
+  size_t wide_ids[3];
+  size_t nb_wide = 0;
+  colors256_foreach (color_id, w2)
+    if (nb_wide < 3)
+      wide_ids[nb_wide++] = color_id;
+  EXPECT ((nb_wide == 3 && wide_ids[0] == 0 && wide_ids[1] == 127
+	   && wide_ids[2] == 200),
+	  "colors256_foreach ([0,127,200]) visits 0, 127, 200");
+
+  fputs ("\n", stdout);
+
+  colors_t unit[9];
+  colors_t *subgrid[9];
+  for (size_t i = 0; i < 9; i++)
+    subgrid[i] = &unit[i];
+
+  /* Testing subgrid_consistency */
+  /*******************************/
+  fputs ("subgrid_consistency\n"
+	 "===================\n", stdout);
+
+  /* a solved unit, then a pair [07] replacing the singleton 7 */
+  for (size_t i = 0; i < 9; i++)
+    unit[i] = colors_set (i);
+  EXPECT ((subgrid_consistency (unit, 9)),
+	  "subgrid_consistency([0], [1], ... ,[8]) == true");
+  unit[7] = colors_add (unit[7], 0);
+  EXPECT ((subgrid_consistency (unit, 9)),
+	  "subgrid_consistency([0], ... ,[07], [8]) == true");
+  unit[7] = colors_set (0);
+  unit[8] = colors_add (colors_add (colors_set (0), 7), 8);
+  EXPECT ((!subgrid_consistency (unit, 9)),
+	  "subgrid_consistency([0], ... ,[0], [078]) == false");
+  unit[8] = colors_set (8);
+  unit[7] = colors_empty ();
+  EXPECT ((!subgrid_consistency (unit, 9)),
+	  "subgrid_consistency([0], ... ,[], [8]) == false");
+  unit[7] = colors_set (7);
+  unit[8] = colors_set (7);
+  EXPECT ((!subgrid_consistency (unit, 9)),
+	  "subgrid_consistency([0], ... ,[7], [7]) == false");
+  EXPECT ((!subgrid_consistency (NULL, 9)),
+	  "subgrid_consistency(NULL) == false");
+
+  fputs ("\n", stdout);
+
+  /* Testing the hidden singles of subgrid_heuristics */
+  /****************************************************/
+  fputs ("subgrid_heuristics (hidden singles)\n"
+	 "===================================\n", stdout);
+
+  /* the colors 0 and 3 are only seen in the cells 1 and 2 */
+  subgrid_heuristics_select (HEURISTIC_LONE_NUMBER, SUBSET_MAX_DEFAULT);
+  unit[0] = unit[3] = colors_add (colors_set (1), 2);
+  unit[1] = colors_add (colors_full (3), 0);
+  unit[2] = colors_add (colors_set (2), 3);
+  EXPECT ((subgrid_heuristics (subgrid, 4)),
+	  "subgrid_heuristics([12], [012], [23], [12]) == true");
+  EXPECT ((unit[1] == colors_set (0) && unit[2] == colors_set (3)
+	   && unit[0] == colors_add (colors_set (1), 2)),
+	  "subgrid_heuristics([12], [012], [23], [12]) "
+	  "== [12], [0], [3], [12]");
+
+  /* the colors 0 and 3 are only seen in the cell 1 */
+  unit[1] = colors_add (colors_full (3), 3);
+  unit[2] = colors_add (colors_set (1), 2);
+  EXPECT ((subgrid_heuristics (subgrid, 4) && unit[1] == colors_empty ()),
+	  "subgrid_heuristics([12], [0123], [12], [12]) empties the cell 1");
+
+  fputs ("\n", stdout);
+
+  /* Testing the naked subsets of subgrid_heuristics */
+  /***************************************************/
+  fputs ("subgrid_heuristics (naked subsets)\n"
+	 "==================================\n", stdout);
+
+  /* naked pair [0,1] in the cells 0 and 3 */
+  subgrid_heuristics_select (HEURISTIC_NAKED_SUBSET, 2);
+  for (size_t i = 0; i < 4; i++)
+    unit[i] = colors_full (4);
+  unit[0] = unit[3] = colors_add (colors_set (0), 1);
+  EXPECT ((subgrid_heuristics (subgrid, 4)),
+	  "subgrid_heuristics([01], [0123], [0123], [01]) == true");
+  EXPECT ((unit[1] == colors_add (colors_set (2), 3)
+	   && unit[2] == colors_add (colors_set (2), 3)
+	   && unit[0] == colors_add (colors_set (0), 1)),
+	  "subgrid_heuristics([01], [0123], [0123], [01]) "
+	  "== [01], [23], [23], [01]");
+  EXPECT ((!subgrid_heuristics (subgrid, 4)),
+	  "subgrid_heuristics([01], [23], [23], [01]) == false");
+
+  /* naked triple [0,1,2] in the cells 0, 1 and 2, no cell holds all of it */
+  for (size_t i = 0; i < 9; i++)
+    unit[i] = colors_full (9);
+  unit[0] = colors_add (colors_set (0), 1);
+  unit[1] = colors_add (colors_set (1), 2);
+  unit[2] = colors_add (colors_set (0), 2);
+  subgrid_heuristics_select (HEURISTIC_NAKED_SUBSET, 2);
+  EXPECT ((!subgrid_heuristics (subgrid, 9)),
+	  "subgrid_heuristics(triple, max 2) == false");
+  subgrid_heuristics_select (HEURISTIC_NAKED_SUBSET, 3);
+  EXPECT ((subgrid_heuristics (subgrid, 9)),
+	  "subgrid_heuristics(triple, max 3) == true");
+  bool triple_removed = true;
+  for (size_t i = 3; i < 9; i++)
+    if (unit[i] != colors_subtract (colors_full (9), colors_full (3)))
+      triple_removed = false;
+  EXPECT ((triple_removed),
+	  "subgrid_heuristics(triple, max 3) removes [0,1,2] elsewhere");
+
+  /* Testing the hidden subsets of subgrid_heuristics */
+  /****************************************************/
+  fputs ("\n"
+	 "subgrid_heuristics (hidden subsets)\n"
+	 "===================================\n", stdout);
+
+  /* hidden pair [0,1] in the cells 0 and 3 */
+  subgrid_heuristics_select (HEURISTIC_HIDDEN_SUBSET, 2);
+  unit[0] = unit[3] = colors_full (4);
+  unit[1] = unit[2] = colors_add (colors_set (2), 3);
+  EXPECT ((subgrid_heuristics (subgrid, 4)),
+	  "subgrid_heuristics([0123], [23], [23], [0123]) == true");
+  EXPECT ((unit[0] == colors_add (colors_set (0), 1)
+	   && unit[3] == colors_add (colors_set (0), 1)
+	   && unit[1] == colors_add (colors_set (2), 3)),
+	  "subgrid_heuristics([0123], [23], [23], [0123]) "
+	  "== [01], [23], [23], [01]");
+  EXPECT ((!subgrid_heuristics (subgrid, 4)),
+	  "subgrid_heuristics([01], [23], [23], [01]) == false");
+
+  /* hidden triple [0,1,2] in the cells 0, 1 and 2 */
+  for (size_t i = 0; i < 9; i++)
+    unit[i] = colors_subtract (colors_full (9), colors_full (3));
+  unit[0] = colors_add (unit[0], 0);
+  unit[0] = colors_add (unit[0], 1);
+  unit[1] = colors_add (unit[1], 1);
+  unit[1] = colors_add (unit[1], 2);
+  unit[2] = colors_add (unit[2], 0);
+  unit[2] = colors_add (unit[2], 2);
+  subgrid_heuristics_select (HEURISTIC_HIDDEN_SUBSET, 2);
+  EXPECT ((!subgrid_heuristics (subgrid, 9)),
+	  "subgrid_heuristics(hidden triple, max 2) == false");
+  subgrid_heuristics_select (HEURISTIC_HIDDEN_SUBSET, 3);
+  EXPECT ((subgrid_heuristics (subgrid, 9)),
+	  "subgrid_heuristics(hidden triple, max 3) == true");
+  EXPECT ((unit[0] == colors_add (colors_set (0), 1)
+	   && unit[1] == colors_add (colors_set (1), 2)
+	   && unit[2] == colors_add (colors_set (0), 2)
+	   && unit[3] == colors_subtract (colors_full (9), colors_full (3))),
+	  "subgrid_heuristics(hidden triple, max 3) keeps only [0,1,2] "
+	  "in its cells");
+
+  /* Testing the size-specialized subgrid heuristics */
+  /***************************************************/
+  fputs ("\n"
+	 "subgrid9_heuristics, subgrid36_heuristics\n"
+	 "=========================================\n", stdout);
+
+  /* hidden single 8 in the cell 4, the others are [0..7] */
+  subgrid_heuristics_select (HEURISTIC_LONE_NUMBER, SUBSET_MAX_DEFAULT);
+  colors16_t unit9[9];
+  colors16_t *subgrid9[9];
+  for (size_t i = 0; i < 9; i++)
+    {
+      unit9[i] = colors16_full (8);
+      subgrid9[i] = &unit9[i];
+    }
+  unit9[4] = colors16_full (9);
+  EXPECT ((colors16_subgrid9_heuristics (subgrid9, 9)
+	   && unit9[4] == colors16_set (8) && unit9[3] == colors16_full (8)),
+	  "colors16_subgrid9_heuristics(hidden single 8) == [8] in cell 4");
+
+  /* cross-hatching of the singleton 35 in the cell 0 */
+  subgrid_heuristics_select (HEURISTIC_CROSS_HATCHING, SUBSET_MAX_DEFAULT);
+  colors_t unit36[36];
+  colors_t *subgrid36[36];
+  for (size_t i = 0; i < 36; i++)
+    {
+      unit36[i] = colors_full (36);
+      subgrid36[i] = &unit36[i];
+    }
+  unit36[0] = colors_set (35);
+  EXPECT ((subgrid36_heuristics (subgrid36, 36)
+	   && unit36[35] == colors_full (35) && unit36[0] == colors_set (35)),
+	  "subgrid36_heuristics(singleton 35) removes 35 elsewhere");
+
+  subgrid_heuristics_select (HEURISTICS_DEFAULT, SUBSET_MAX_DEFAULT);
+
+  fputs ("\n", stdout);
+
   return EXIT_SUCCESS;
 }
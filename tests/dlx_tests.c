@@ -0,0 +1,86 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <colors.h>
+#include <dlx.h>
+#include <grid.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c dlx_tests.c */
+/* gcc -o dlx_tests dlx_tests.o tests_utils.o dlx.o grid.o colors.o units.o */
+
+int
+main (void)
+{
+  fputs ("Testing NULL grids\n"
+	 "==================\n", stdout);
+
+  EXPECT ((dlx_solve (NULL) == 2), "dlx_solve(NULL) == 2");
+  EXPECT ((dlx_count_solutions (NULL, 0) == 0),
+	  "dlx_count_solutions(NULL, 0) == 0");
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing dlx_solve\n"
+	 "=================\n", stdout);
+
+  const char *puzzle =
+    "_____59_6" "_______7_" "_9_46_52_"
+    "_6_____9_" "1___86__5" "_8_3____1"
+    "_14_____7" "3___5____" "__69____3";
+
+  grid_t *grid = grid_from_string (9, puzzle);
+  EXPECT ((dlx_solve (grid) == 0), "dlx_solve(grid) == 0");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+
+  bool givens_kept = true;
+  for (size_t i = 0; i < 81; ++i)
+    if (puzzle[i] != EMPTY_CELL
+	&& grid_get_colors (grid, i / 9, i % 9)
+	   != colors_set (strchr (color_table, puzzle[i]) - color_table))
+      givens_kept = false;
+  EXPECT ((givens_kept), "dlx_solve(grid) keeps the given cells");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1__1" "____" "____" "____");
+  EXPECT ((dlx_solve (grid) == 2), "dlx_solve(inconsistent grid) == 2");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1___" "2___" "3___" "___4");
+  EXPECT ((dlx_solve (grid) == 2), "dlx_solve(unsolvable grid) == 2");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing dlx_count_solutions\n"
+	 "===========================\n", stdout);
+
+  grid = grid_from_string (9, puzzle);
+  EXPECT ((dlx_count_solutions (grid, 0) == 1),
+	  "dlx_count_solutions(unique grid, 0) == 1");
+  char *str = grid_get_cell (grid, 0, 0);
+  EXPECT ((strlen (str) == 9), "dlx_count_solutions() leaves the grid as is");
+  free (str);
+  grid_free (grid);
+
+  grid = grid_from_string (4, "________________");
+  EXPECT ((dlx_count_solutions (grid, 0) == 288),
+	  "dlx_count_solutions(empty 4x4 grid, 0) == 288");
+  EXPECT ((dlx_count_solutions (grid, 10) == 10),
+	  "dlx_count_solutions(empty 4x4 grid, 10) == 10");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1__1" "____" "____" "____");
+  EXPECT ((dlx_count_solutions (grid, 0) == 0),
+	  "dlx_count_solutions(inconsistent grid, 0) == 0");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
@@ -5,50 +5,16 @@
 #include <stdlib.h>
 #include <unistd.h>
 
-#include <stdarg.h>
 #include <string.h>
 #include <time.h>
 
 #include <colors.h>
 #include <grid.h>
 
-/* gcc -I ../include -c grid_tests.c */
-/* gcc -o grid_tests grid_tests.o grid.o colors.o */
-
-void
-EXPECT (bool test, char *fmt, ...)
-{
-  fprintf (stdout, "Checking '");
-
-  va_list vargs;
-  va_start(vargs, fmt);
-  vprintf(fmt, vargs);
-  va_end(vargs);
-
-  if (test)
-    fprintf (stdout, "': (passed)\n");
-  else
-    fprintf (stdout, "': (failed!)\n");
-}
-
-void
-ASSERT (bool test, char *fmt, ...)
-{
-  fprintf (stdout, "Checking '");
+#include "tests_utils.h"
 
-  va_list vargs;
-  va_start(vargs, fmt);
-  vprintf(fmt, vargs);
-  va_end(vargs);
-
-  if (test)
-    fprintf (stdout, "': (passed)\n");
-  else
-    {
-      fprintf (stdout, "': (critical fail!) aborting...\n");
-      exit (EXIT_FAILURE);
-    }
-}
+/* gcc -I ../include -c grid_tests.c */
+/* gcc -o grid_tests grid_tests.o tests_utils.o grid.o colors.o units.o */
 
 void
 grid_tests (size_t size)
@@ -75,14 +41,26 @@ grid_tests (size_t size)
   if (size < MAX_COLORS)
     EXPECT ((!grid_check_char (grid, color_table[size])),
 	    "grid_check_char('%c') == false", color_table[size]);
-  EXPECT ((!grid_check_char (grid, '+')), "grid_check_char('+') == false");
-  EXPECT ((!grid_check_char (grid, '0')), "grid_check_char('0') == false");
+  if (size <= MAX_COLORS)
+    {
+      EXPECT ((!grid_check_char (grid, '+')), "grid_check_char('+') == false");
+      EXPECT ((!grid_check_char (grid, '0')), "grid_check_char('0') == false");
+    }
+  EXPECT ((!grid_check_char (grid, '#')), "grid_check_char('#') == false");
 
   /* Checking grid_set_cell() with random initialization of the grid */
   for (size_t i = 0; i < grid_get_size (grid); ++i)
     for (size_t j = 0; j < grid_get_size (grid); ++j)
       grid_set_cell (grid, i, j, color_table[random () % size]);
 
+  /* Checking grid_set_colors() and grid_get_colors() */
+  grid_set_colors (grid, 0, 0, colors_full (MAX_COLORS));
+  EXPECT ((grid_get_colors (grid, 0, 0) == colors_full (size)),
+	  "grid_get_colors(grid_set_colors(grid, 0, 0, [0, ... ,63])) == "
+	  "[0, ... ,%zu]", size - 1);
+  EXPECT ((grid_get_colors (grid, size, 0) == colors_empty ()),
+	  "grid_get_colors (grid, %zu, 0) == []", size);
+
   /* Checking grid_print() and grid_get_cell() */
   grid_print (grid, stdout);
   EXPECT ((true), "grid_print(grid)");
@@ -116,7 +94,6 @@ grid_tests (size_t size)
   EXPECT ((grid_get_cell (grid, size + 1, size + 1) == NULL),
 	  "grid_get_cell (grid, %zu, %zu) == NULL", size + 1, size + 1);
 
-
   /* Checking side-effects on an attempt to set a cell out of bounds */
   grid_set_cell (grid, size + 2, size / 2, '1');
   is_equal = true;
@@ -134,6 +111,30 @@ grid_tests (size_t size)
   EXPECT ((is_equal),
 	  "no side effect on grid_set_cell(grid, size + 2, size / 2, '1')");
 
+  /* Checking grid_checkpoint() and grid_rollback() */
+  size_t checkpoint = grid_checkpoint (grid);
+  for (size_t i = 0; i < grid_get_size (grid); ++i)
+    for (size_t j = 0; j < grid_get_size (grid); ++j)
+      grid_set_cell (grid, i, j, color_table[random () % size]);
+  size_t inner_checkpoint = grid_checkpoint (grid);
+  grid_set_cell (grid, 0, 0, EMPTY_CELL);
+  grid_rollback (grid, inner_checkpoint);
+  grid_set_cell (grid, size - 1, 0, EMPTY_CELL);
+  grid_rollback (grid, checkpoint);
+  is_equal = true;
+  for (size_t i = 0; i < grid_get_size (grid); ++i)
+    for (size_t j = 0; j < grid_get_size (grid); ++j)
+      {
+	char *str1 = grid_get_cell (grid, i, j),
+	     *str2 = grid_get_cell (grid2, i, j);
+
+	if (strcmp (str1, str2))
+	  is_equal = false;
+	free(str1);
+	free(str2);
+      }
+  EXPECT ((is_equal), "grid == grid_rollback(grid, grid_checkpoint(grid))");
+
   /* Checking grid_free() */
   grid_free (grid);
   grid_free (grid2);
@@ -142,6 +143,137 @@ grid_tests (size_t size)
   fputs ("\n", stdout);
 }
 
+void
+solver_tests (void)
+{
+  fputs (" Testing grid_solve\n"
+	 "==========================\n", stdout);
+
+  const char *puzzle =
+    "_____59_6" "_______7_" "_9_46_52_"
+    "_6_____9_" "1___86__5" "_8_3____1"
+    "_14_____7" "3___5____" "__69____3";
+
+  grid_t *grid = grid_from_string (9, puzzle);
+  EXPECT ((grid_solve (grid) == 0), "grid_solve(grid) == 0");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+
+  bool givens_kept = true;
+  for (size_t i = 0; i < 81; ++i)
+    if (puzzle[i] != EMPTY_CELL)
+      {
+	char *str = grid_get_cell (grid, i / 9, i % 9);
+	if (str[0] != puzzle[i] || str[1] != '\0')
+	  givens_kept = false;
+	free (str);
+      }
+  EXPECT ((givens_kept), "grid_solve(grid) keeps the given cells");
+  grid_free (grid);
+
+  /* placing and removing colors through grid_set_cell() and rollbacks */
+  grid = grid_from_string (4, "1___" "____" "____" "____");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+  EXPECT ((!grid_is_solved (grid)), "grid_is_solved(grid) == false");
+  size_t checkpoint = grid_checkpoint (grid);
+  grid_set_cell (grid, 3, 0, '1');
+  EXPECT ((!grid_is_consistent (grid)),
+	  "grid_is_consistent(grid with '1' twice in a column) == false");
+  grid_rollback (grid, checkpoint);
+  EXPECT ((grid_is_consistent (grid)),
+	  "grid_is_consistent(grid_rollback(grid)) == true");
+  grid_free (grid);
+
+  grid = grid_from_string (4, "1234" "3412" "2143" "4321");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(full grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(full grid) == true");
+  grid_free (grid);
+
+  /* two '1' in the first row */
+  grid = grid_from_string (4, "1__1" "____" "____" "____");
+  EXPECT ((grid_solve (grid) == 2), "grid_solve(inconsistent grid) == 2");
+  grid_free (grid);
+
+  /* box-line intersections: in the top-left block, the '1' can only be on
+   * the first row, so it is removed from the rest of the row */
+  grid = grid_alloc (4);
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t j = 0; j < 4; ++j)
+      grid_set_cell (grid, i, j, EMPTY_CELL);
+  grid_set_colors (grid, 1, 0, colors_discard (colors_full (4), 0));
+  grid_set_colors (grid, 1, 1, colors_discard (colors_full (4), 0));
+  subgrid_heuristics_select (HEURISTIC_INTERSECTION, SUBSET_MAX_DEFAULT);
+  EXPECT ((grid_heuristics (grid) == 1), "grid_heuristics(pointing) == 1");
+  EXPECT ((!colors_is_in (grid_get_colors (grid, 0, 2), 0)
+	   && !colors_is_in (grid_get_colors (grid, 0, 3), 0)),
+	  "grid_heuristics(pointing) removes '1' from the rest of the row");
+  EXPECT ((colors_is_in (grid_get_colors (grid, 0, 0), 0)
+	   && colors_is_in (grid_get_colors (grid, 2, 2), 0)),
+	  "grid_heuristics(pointing) keeps '1' elsewhere");
+  subgrid_heuristics_select (HEURISTICS_DEFAULT, SUBSET_MAX_DEFAULT);
+  grid_free (grid);
+
+  /* x-wing: the '1' of the rows 0 and 2 can only be in the columns 0 and 2,
+   * so it is removed from these columns on the rows 1 and 3 */
+  grid = grid_alloc (4);
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t j = 0; j < 4; ++j)
+      if ((i == 0 || i == 2) && (j == 1 || j == 3))
+	grid_set_colors (grid, i, j, colors_discard (colors_full (4), 0));
+      else
+	grid_set_cell (grid, i, j, EMPTY_CELL);
+  subgrid_heuristics_select (HEURISTIC_FISH, SUBSET_MAX_DEFAULT);
+  EXPECT ((grid_heuristics (grid) == 1), "grid_heuristics(x-wing) == 1");
+  EXPECT ((!colors_is_in (grid_get_colors (grid, 1, 0), 0)
+	   && !colors_is_in (grid_get_colors (grid, 3, 2), 0)),
+	  "grid_heuristics(x-wing) removes '1' from the columns 0 and 2");
+  EXPECT ((colors_is_in (grid_get_colors (grid, 1, 1), 0)
+	   && colors_is_in (grid_get_colors (grid, 0, 0), 0)),
+	  "grid_heuristics(x-wing) keeps '1' elsewhere");
+  subgrid_heuristics_select (HEURISTICS_DEFAULT, SUBSET_MAX_DEFAULT);
+  grid_free (grid);
+
+  /* consistent start, but no solution: column 0 needs a '4' in row 3 */
+  grid = grid_from_string (4, "1___" "2___" "3___" "___4");
+  EXPECT ((grid_solve (grid) == 2), "grid_solve(unsolvable grid) == 2");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+}
+
+/* Solve a grid wider than MAX_COLORS built from a shifted pattern with a
+ * fifth of its cells removed */
+void
+wide_solver_tests (size_t size, size_t block_size)
+{
+  fprintf (stdout,
+	   " Testing grid_solve on size %zu\n"
+	   "==========================\n", size);
+
+  grid_t *grid = grid_alloc (size);
+  for (size_t i = 0; i < size; ++i)
+    for (size_t j = 0; j < size; ++j)
+      {
+	size_t color_id =
+	  (block_size * (i % block_size) + i / block_size + j) % size;
+	if ((i * 13 + j * 7 + i * j) % 5 == 0)
+	  grid_set_cell (grid, i, j, EMPTY_CELL);
+	else
+	  grid_set_cell (grid, i, j, color_table[color_id]);
+      }
+  EXPECT ((grid_has_color (grid, 0, 0, size - 1)),
+	  "grid_has_color(grid, 0, 0, %zu) == true", size - 1);
+  EXPECT ((grid_has_color (grid, 0, 1, 1)
+	   && !grid_has_color (grid, 0, 1, 2)),
+	  "grid_has_color(grid, 0, 1, ...) == [1]");
+  EXPECT ((grid_solve (grid) == 0), "grid_solve(grid) == 0");
+  EXPECT ((grid_is_solved (grid)), "grid_is_solved(grid) == true");
+  EXPECT ((grid_is_consistent (grid)), "grid_is_consistent(grid) == true");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+}
+
 int
 main (void)
 {
@@ -156,6 +288,7 @@ main (void)
   EXPECT ((grid_alloc (0) == NULL), "grid_alloc(0) == NULL");
   EXPECT ((grid_alloc (17) == NULL), "grid_alloc(17) == NULL");
   EXPECT ((grid_alloc (65) == NULL), "grid_alloc(65) == NULL");
+  EXPECT ((grid_alloc (169) == NULL), "grid_alloc(169) == NULL");
 
   /* Checking grid_get_size() */
   EXPECT ((grid_get_size (NULL) == 0), "grid_get_size(NULL) == 0");
@@ -179,6 +312,20 @@ main (void)
   grid_set_cell (NULL, 1, 1, '1');
   EXPECT ((true), "grid_set_cell(NULL, 1, 1, '1')");
 
+  /* Checking grid_get_colors() and grid_set_colors() */
+  EXPECT ((grid_get_colors (NULL, 1, 1) == colors_empty ()),
+	  "grid_get_colors(NULL, 1, 1) == []");
+  grid_set_colors (NULL, 1, 1, colors_set (0));
+  EXPECT ((true), "grid_set_colors(NULL, 1, 1, [0])");
+
+  /* Checking grid_checkpoint() and grid_rollback() */
+  EXPECT ((grid_checkpoint (NULL) == 0), "grid_checkpoint(NULL) == 0");
+  grid_rollback (NULL, 0);
+  EXPECT ((true), "grid_rollback(NULL, 0)");
+
+  /* Checking grid_solve() */
+  EXPECT ((grid_solve (NULL) == 2), "grid_solve(NULL) == 2");
+
   fputs ("\n", stdout);
 
   /* Positive tests on valid grid sizes */
@@ -190,6 +337,14 @@ main (void)
   grid_tests (36);
   grid_tests (49);
   grid_tests (64);
+  grid_tests (81);
+  grid_tests (100);
+  grid_tests (121);
+  grid_tests (144);
+
+  solver_tests ();
+  wide_solver_tests (81, 9);
+  wide_solver_tests (144, 12);
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <colors.h>
+#include <grid.h>
+#include <parallel.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c parallel_tests.c */
+/* gcc -o parallel_tests parallel_tests.o tests_utils.o parallel.o pool.o
+ * grid.o colors.o units.o -pthread */
+
+int
+main (void)
+{
+  fputs ("Testing NULL grids\n"
+	 "==================\n", stdout);
+
+  EXPECT ((parallel_solve (NULL, 4) == 2), "parallel_solve(NULL, 4) == 2");
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing parallel_solve\n"
+	 "======================\n", stdout);
+
+  /* a 16x16 grid with a single solution */
+  const char *puzzle =
+    "_F__________CG__" "__5_CG49_F_D____" "__E7_F___A1__B4_"
+    "8__D______9__A__" "9___5_G_B7__E___" "____27__A6E__D__"
+    "_6__4EF_1_35__B_" "______B___2_____" "_D_3__62__F____E"
+    "6_CE____9_____2_" "_B_4E_3___D___87" "___8_9_G_B7A5___"
+    "D4_9__8F_____6A2" "_8B____7_____31_" "_1____9642_F___8"
+    "C_____2____B_7E_";
+
+  grid_t *grid = grid_from_string (16, puzzle);
+  grid_t *expected = grid_from_string (16, puzzle);
+  EXPECT ((parallel_solve (grid, 4) == 0), "parallel_solve(grid, 4) == 0");
+  EXPECT ((grid_is_solved (grid) && grid_is_consistent (grid)),
+	  "parallel_solve(grid, 4) is solved and consistent");
+  grid_solve (expected);
+  EXPECT ((grid_equal (grid, expected)),
+	  "parallel_solve(grid, 4) == grid_solve(grid)");
+  grid_free (grid);
+
+  grid = grid_from_string (16, puzzle);
+  EXPECT ((parallel_solve (grid, 1) == 0 && grid_equal (grid, expected)),
+	  "parallel_solve(grid, 1) == grid_solve(grid)");
+  grid_free (grid);
+  grid_free (expected);
+
+  size_t sizes[] = {16, 25, 36};
+  for (size_t i = 0; i < 3; ++i)
+    {
+      grid = grid_empty (sizes[i]);
+      EXPECT ((parallel_solve (grid, 8) == 0 && grid_is_solved (grid)
+	       && grid_is_consistent (grid)),
+	      "parallel_solve(empty %zux%zu, 8) is solved and consistent",
+	      sizes[i], sizes[i]);
+      grid_free (grid);
+    }
+
+  grid = grid_empty (16);
+  grid_set_cell (grid, 0, 0, '1');
+  grid_set_cell (grid, 0, 15, '1');
+  EXPECT ((parallel_solve (grid, 4) == 2),
+	  "parallel_solve(inconsistent grid, 4) == 2");
+  grid_free (grid);
+
+  /* the cell (0, 3) can only take the 4, already in its column */
+  grid = grid_from_string (4, "123_" "____" "___4" "____");
+  EXPECT ((parallel_solve (grid, 4) == 2),
+	  "parallel_solve(unsolvable grid, 4) == 2");
+  grid_free (grid);
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pool.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c pool_tests.c */
+/* gcc -o pool_tests pool_tests.o tests_utils.o pool.o grid.o colors.o
+ * units.o -pthread */
+
+static atomic_size_t counter;
+
+void
+count_task (void *arg)
+{
+  (void) arg;
+  atomic_fetch_add (&counter, 1);
+}
+
+/* a task of depth d submits two tasks of depth d - 1 from its worker */
+typedef struct
+{
+  pool_t *pool;
+  size_t depth;
+} tree_task_t;
+
+void
+tree_task (void *arg)
+{
+  tree_task_t *task = arg;
+  atomic_fetch_add (&counter, 1);
+  if (task->depth > 0)
+    for (size_t i = 0; i < 2; ++i)
+      {
+	tree_task_t *child = malloc (sizeof (tree_task_t));
+	child->pool = task->pool;
+	child->depth = task->depth - 1;
+	pool_submit (task->pool, tree_task, child);
+      }
+  free (task);
+}
+
+int
+main (void)
+{
+  fputs ("Testing NULL pools\n"
+	 "==================\n", stdout);
+
+  pool_free (NULL);
+  pool_wait (NULL);
+  pool_submit (NULL, count_task, NULL);
+  EXPECT ((pool_is_hungry (NULL) == false), "pool_is_hungry(NULL) == false");
+
+  fputs ("\n", stdout);
+
+  fputs ("Testing pool_submit, pool_wait\n"
+	 "==============================\n", stdout);
+
+  pool_t *pool = pool_alloc (4);
+  atomic_init (&counter, 0);
+  for (size_t i = 0; i < 1000; ++i)
+    pool_submit (pool, count_task, NULL);
+  pool_wait (pool);
+  EXPECT ((atomic_load (&counter) == 1000),
+	  "pool_wait() after 1000 tasks: 1000 tasks run");
+
+  atomic_store (&counter, 0);
+  tree_task_t *root = malloc (sizeof (tree_task_t));
+  root->pool = pool;
+  root->depth = 10;
+  pool_submit (pool, tree_task, root);
+  pool_wait (pool);
+  EXPECT ((atomic_load (&counter) == 2047),
+	  "pool_wait() after a tree of tasks: 2047 tasks run");
+  pool_free (pool);
+
+  pool = pool_alloc (0);
+  atomic_store (&counter, 0);
+  for (size_t i = 0; i < 10; ++i)
+    pool_submit (pool, count_task, NULL);
+  pool_free (pool);
+  EXPECT ((atomic_load (&counter) == 10),
+	  "pool_free(pool of 0 threads) runs its 10 tasks");
+
+  fputs ("\n", stdout);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <stdarg.h>
+
+#include <grid.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c tests_utils.c */
+
+void
+EXPECT (bool test, char *fmt, ...)
+{
+  fprintf (stdout, "Checking '");
+
+  va_list vargs;
+  va_start(vargs, fmt);
+  vprintf(fmt, vargs);
+  va_end(vargs);
+
+  if (test)
+    fprintf (stdout, "': (passed)\n");
+  else
+    fprintf (stdout, "': (failed!)\n");
+}
+
+void
+ASSERT (bool test, char *fmt, ...)
+{
+  fprintf (stdout, "Checking '");
+
+  va_list vargs;
+  va_start(vargs, fmt);
+  vprintf(fmt, vargs);
+  va_end(vargs);
+
+  if (test)
+    fprintf (stdout, "': (passed)\n");
+  else
+    {
+      fprintf (stdout, "': (critical fail!) aborting...\n");
+      exit (EXIT_FAILURE);
+    }
+}
+
+grid_t *
+grid_from_string (size_t size, const char *cells)
+{
+  grid_t *grid = grid_alloc (size);
+  for (size_t i = 0; i < size; ++i)
+    for (size_t j = 0; j < size; ++j)
+      grid_set_cell (grid, i, j, cells[i * size + j]);
+  return grid;
+}
+
+grid_t *
+grid_empty (size_t size)
+{
+  grid_t *grid = grid_alloc (size);
+  for (size_t i = 0; i < size; ++i)
+    for (size_t j = 0; j < size; ++j)
+      grid_set_cell (grid, i, j, EMPTY_CELL);
+  return grid;
+}
+
+bool
+grid_equal (const grid_t *grid1, const grid_t *grid2)
+{
+  size_t size = grid_get_size (grid1);
+  if (grid_get_size (grid2) != size)
+    return false;
+  for (size_t i = 0; i < size; ++i)
+    for (size_t j = 0; j < size; ++j)
+      for (size_t k = 0; k < size; ++k)
+	if (grid_has_color (grid1, i, j, k) != grid_has_color (grid2, i, j, k))
+	  return false;
+  return true;
+}
@@ -0,0 +1,26 @@
+#ifndef TESTS_UTILS_H
+#define TESTS_UTILS_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <grid.h>
+
+/* Helpers shared by the test programs, see tests_utils.c */
+
+/* print a check and whether it passed */
+void EXPECT (bool test, char *fmt, ...);
+
+/* same as EXPECT(), but exits the test program if the check fails */
+void ASSERT (bool test, char *fmt, ...);
+
+/* Fill a grid of the given size from a string of size * size chars */
+grid_t *grid_from_string (size_t size, const char *cells);
+
+/* an empty grid of the given size */
+grid_t *grid_empty (size_t size);
+
+/* true if both grids have the same candidates in each cell */
+bool grid_equal (const grid_t *grid1, const grid_t *grid2);
+
+#endif /* TESTS_UTILS_H */
@@ -0,0 +1,107 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <units.h>
+
+#include "tests_utils.h"
+
+/* gcc -I ../include -c units_tests.c */
+/* gcc -o units_tests units_tests.o tests_utils.o units.o grid.o colors.o */
+
+void
+units_tests (size_t size, size_t block_size)
+{
+  fprintf (stdout,
+	   " Testing units of size %zu\n"
+	   "==========================\n", size);
+
+  const units_t *units = units_get (size);
+  EXPECT ((units != NULL), "units_get(%zu) != NULL", size);
+  EXPECT ((units_get (size) == units), "units_get(%zu) is computed once", size);
+  EXPECT ((units->size == size), "units->size == %zu", size);
+  EXPECT ((units->block_size == block_size),
+	  "units->block_size == %zu", block_size);
+  EXPECT ((units->nb_units == 3 * size), "units->nb_units == %zu", 3 * size);
+
+  size_t nb_cells = size * size;
+  size_t seen[nb_cells];
+
+  /* each unit holds size different cells, each cell is in 3 units */
+  bool units_ok = true;
+  memset (seen, 0, sizeof (seen));
+  for (size_t unit_id = 0; unit_id < units->nb_units; ++unit_id)
+    {
+      const cell_id_t *cells = units_cells (units, unit_id);
+      for (size_t i = 0; i < size; ++i)
+	{
+	  seen[cells[i]]++;
+	  for (size_t j = i + 1; j < size; ++j)
+	    if (cells[i] == cells[j])
+	      units_ok = false;
+	}
+    }
+  for (size_t cell_id = 0; cell_id < nb_cells; ++cell_id)
+    if (seen[cell_id] != 3)
+      units_ok = false;
+  EXPECT ((units_ok), "each cell belongs to 3 units");
+
+  /* the units of a cell are its row, its column and its block */
+  bool cell_units_ok = true;
+  for (size_t cell_id = 0; cell_id < nb_cells; ++cell_id)
+    {
+      size_t row = cell_id / size, column = cell_id % size;
+      size_t block = (row / block_size) * block_size + column / block_size;
+      const cell_id_t *cell_units = units_of_cell (units, cell_id);
+      if (cell_units[0] != row || cell_units[1] != size + column
+	  || cell_units[2] != 2 * size + block)
+	cell_units_ok = false;
+    }
+  EXPECT ((cell_units_ok), "units_of_cell() == {row, column, block}");
+
+  /* the positions of a cell lead back to it in each of its units */
+  bool positions_ok = true;
+  for (size_t cell_id = 0; cell_id < nb_cells; ++cell_id)
+    {
+      const cell_id_t *cell_units = units_of_cell (units, cell_id);
+      const cell_id_t *positions = units_positions_of_cell (units, cell_id);
+      for (size_t k = 0; k < 3; ++k)
+	if (positions[k] >= size
+	    || units_cells (units, cell_units[k])[positions[k]] != cell_id)
+	  positions_ok = false;
+    }
+  EXPECT ((positions_ok),
+	  "units_cells(units_of_cell())[units_positions_of_cell()] == cell");
+
+  fputs ("\n", stdout);
+}
+
+int
+main (void)
+{
+  fputs ("Testing invalid sizes\n"
+	 "=====================\n", stdout);
+
+  EXPECT ((units_get (0) == NULL), "units_get(0) == NULL");
+  EXPECT ((units_get (17) == NULL), "units_get(17) == NULL");
+  EXPECT ((units_get (169) == NULL), "units_get(169) == NULL");
+
+  fputs ("\n", stdout);
+
+  units_tests (1, 1);
+  units_tests (4, 2);
+  units_tests (9, 3);
+  units_tests (16, 4);
+  units_tests (25, 5);
+  units_tests (36, 6);
+  units_tests (49, 7);
+  units_tests (64, 8);
+  units_tests (81, 9);
+  units_tests (100, 10);
+  units_tests (121, 11);
+  units_tests (144, 12);
+
+  return EXIT_SUCCESS;
+}